@@ -0,0 +1,136 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace mk::Bench
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    inline const volatile void *g_sink = nullptr;
+#endif
+
+    // Keeps the compiler from optimizing away a result that is otherwise unused. The empty asm claims to read
+    // the value and all memory, so whatever computed it has to happen.
+    template <typename T>
+    inline void DoNotOptimize(const T &value)
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        // No inline asm on MSVC x64, escape the address and fence the compiler instead
+        g_sink = &value;
+        _ReadWriteBarrier();
+#else
+        asm volatile("" : : "r,m"(value) : "memory");
+#endif
+    }
+
+    struct Result
+    {
+        std::string name;
+        uint64_t iterations = 0;
+        uint32_t repetitions = 0;
+        double minNsPerOp = 0.0;
+        double medianNsPerOp = 0.0;
+        double maxNsPerOp = 0.0;
+    };
+
+    class Runner
+    {
+    private:
+        std::vector<Result> m_results;
+        std::string m_filter;
+        uint32_t m_repetitions = 5;
+        double m_iterationScale = 1.0;
+
+    public:
+        Runner(const std::string &filter, uint32_t repetitions, double iterationScale)
+            : m_filter(filter), m_repetitions(std::max(repetitions, 1u)), m_iterationScale(iterationScale) {}
+        ~Runner() = default;
+
+        // Calls func(iterations) once per repetition and records the time per iteration
+        template <typename F>
+        void Run(const std::string &name, uint64_t iterations, F &&func)
+        {
+            Run(name, iterations, [](uint64_t) {}, func);
+        }
+
+        // Same as above, but calls setup(iterations) before every repetition outside of the timed region
+        template <typename S, typename F>
+        void Run(const std::string &name, uint64_t iterations, S &&setup, F &&func)
+        {
+            if (!m_filter.empty() && name.find(m_filter) == std::string::npos)
+            {
+                return;
+            }
+
+            iterations = std::max<uint64_t>(static_cast<uint64_t>(iterations * m_iterationScale), 1);
+
+            std::vector<double> samples;
+            samples.reserve(m_repetitions);
+
+            // Warm up caches and allocators before measuring
+            setup(iterations);
+            func(iterations);
+
+            for (uint32_t i = 0; i < m_repetitions; i++)
+            {
+                setup(iterations);
+                const auto start = std::chrono::high_resolution_clock::now();
+                func(iterations);
+                const auto end = std::chrono::high_resolution_clock::now();
+                samples.push_back(std::chrono::duration<double, std::nano>(end - start).count() / iterations);
+            }
+
+            std::sort(samples.begin(), samples.end());
+            m_results.push_back(Result{
+                .name = name,
+                .iterations = iterations,
+                .repetitions = m_repetitions,
+                .minNsPerOp = samples.front(),
+                .medianNsPerOp = samples[samples.size() / 2],
+                .maxNsPerOp = samples.back(),
+            });
+
+            std::cerr << name << ": " << m_results.back().medianNsPerOp << " ns/op" << std::endl;
+        }
+
+        // One JSON object per line so results can be appended to and diffed across runs
+        void WriteJson(std::ostream &out, const std::string &version) const
+        {
+            for (const auto &result : m_results)
+            {
+                out << "{\"name\":\"" << result.name << "\""
+                    << ",\"version\":\"" << version << "\""
+                    << ",\"iterations\":" << result.iterations
+                    << ",\"repetitions\":" << result.repetitions
+                    << ",\"min_ns_per_op\":" << result.minNsPerOp
+                    << ",\"median_ns_per_op\":" << result.medianNsPerOp
+                    << ",\"max_ns_per_op\":" << result.maxNsPerOp
+                    << "}\n";
+            }
+            out.flush();
+        }
+
+        void WriteCsv(std::ostream &out, const std::string &version) const
+        {
+            out << "name,version,iterations,repetitions,min_ns_per_op,median_ns_per_op,max_ns_per_op\n";
+            for (const auto &result : m_results)
+            {
+                out << result.name << "," << version << "," << result.iterations << "," << result.repetitions << ","
+                    << result.minNsPerOp << "," << result.medianNsPerOp << "," << result.maxNsPerOp << "\n";
+            }
+            out.flush();
+        }
+    };
+
+    void RunCoreBenchmarks(Runner &runner);
+    void RunGameBenchmarks(Runner &runner);
+    void RunPhysicsBenchmarks(Runner &runner);
+}
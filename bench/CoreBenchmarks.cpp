@@ -0,0 +1,203 @@
+#include "Benchmark.h"
+
+#include "Core/EntityStore.h"
+#include "Core/EventBus.h"
+#include "Core/Grid.h"
+#include "Core/Pool.h"
+
+#include <glm/glm.hpp>
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace mk::Bench
+{
+    struct Position
+    {
+        glm::vec3 value;
+    };
+
+    struct Velocity
+    {
+        glm::vec3 value;
+    };
+
+    struct Health
+    {
+        float value;
+    };
+
+    struct DamageEvent
+    {
+        uint32_t target;
+        float amount;
+    };
+
+    struct DamageCounter
+    {
+        float total = 0.0f;
+    };
+
+    void RunEntityStoreBenchmarks(Runner &runner)
+    {
+        runner.Run("EntityStore/CreateEntity", 10000, [](uint64_t iterations)
+                   {
+                       EntityStore store;
+                       for (uint64_t i = 0; i < iterations; i++)
+                       {
+                           DoNotOptimize(store.CreateEntity(Position{glm::vec3(float(i))}, Velocity{glm::vec3(1.0f)}, Health{100.0f}));
+                       } });
+
+        // One iteration is a full pass over all entities
+        constexpr uint32_t c_numForEachEntities = 10000;
+        EntityStore forEachStore;
+        for (uint32_t i = 0; i < c_numForEachEntities; i++)
+        {
+            forEachStore.CreateEntity(Position{glm::vec3(float(i))}, Velocity{glm::vec3(1.0f)});
+        }
+
+        runner.Run("EntityStore/ForEach/" + std::to_string(c_numForEachEntities) + "Entities", 100, [&](uint64_t iterations)
+                   {
+                       for (uint64_t i = 0; i < iterations; i++)
+                       {
+                           forEachStore.ForEach<Position, Velocity>([](Position &position, Velocity &velocity)
+                                                                    { position.value += velocity.value * (1.0f / 60.0f); });
+                       }
+                       DoNotOptimize(forEachStore); });
+
+        // The entities are created untimed before every repetition
+        std::unique_ptr<EntityStore> destroyStore;
+        std::vector<Entity> entities;
+        runner.Run(
+            "EntityStore/DestroyEntity", 10000, [&](uint64_t iterations)
+            {
+                destroyStore = std::make_unique<EntityStore>();
+                entities.clear();
+                for (uint64_t i = 0; i < iterations; i++)
+                {
+                    entities.push_back(destroyStore->CreateEntity(Position{glm::vec3(float(i))}, Health{100.0f}));
+                } },
+            [&](uint64_t iterations)
+            {
+                // Destroy from the front so every removal moves the last entity into the hole
+                for (Entity entity : entities)
+                {
+                    destroyStore->DestroyEntity(entity);
+                } });
+    }
+
+    void RunGridBenchmarks(Runner &runner)
+    {
+        std::mt19937 gen(1234);
+        std::uniform_real_distribution<float> dis(-4000.0f, 4000.0f);
+
+        std::vector<glm::vec3> points(4096);
+        for (auto &point : points)
+        {
+            point = glm::vec3(dis(gen), 0.0f, dis(gen));
+        }
+
+        runner.Run("Grid/Build", 100, [&](uint64_t iterations)
+                   {
+                       Grid grid;
+                       for (uint64_t i = 0; i < iterations; i++)
+                       {
+                           grid.Build(points);
+                           DoNotOptimize(grid.GetNodes().size());
+                       } });
+
+        Grid grid;
+        grid.Build(points);
+        runner.Run("Grid/QueryIndices", 10000, [&](uint64_t iterations)
+                   {
+                       for (uint64_t i = 0; i < iterations; i++)
+                       {
+                           const glm::vec2 center = glm::vec2(points[i % points.size()].x, points[i % points.size()].z);
+                           auto indices = grid.QueryIndices(Bounds(center - glm::vec2(250.0f), center + glm::vec2(250.0f)));
+                           DoNotOptimize(indices.size());
+                       } });
+    }
+
+    void RunEventBusBenchmarks(Runner &runner)
+    {
+        EventBus eventBus;
+        DamageCounter counter;
+        for (uint32_t i = 0; i < static_cast<uint32_t>(EventBus::Domain::Count); i++)
+        {
+            eventBus.ClearContext(static_cast<EventBus::Domain>(i));
+        }
+        eventBus.SetContext(EventBus::Domain::Scene, counter);
+        eventBus.Subscribe<DamageCounter, DamageEvent>([](DamageCounter &context, const DamageEvent &event)
+                                                       { context.total += event.amount; });
+
+        runner.Run("EventBus/Dispatch", 100000, [&](uint64_t iterations)
+                   {
+                       for (uint64_t i = 0; i < iterations; i++)
+                       {
+                           eventBus.Dispatch(DamageEvent{static_cast<uint32_t>(i), 1.0f});
+                       }
+                       DoNotOptimize(counter.total); });
+
+        runner.Run("EventBus/QueueAndUpdate", 100000, [&](uint64_t iterations)
+                   {
+                       for (uint64_t i = 0; i < iterations; i++)
+                       {
+                           eventBus.QueueEvent(DamageEvent{static_cast<uint32_t>(i), 1.0f});
+                       }
+                       eventBus.Update();
+                       DoNotOptimize(counter.total); });
+    }
+
+    void RunPoolBenchmarks(Runner &runner)
+    {
+        constexpr size_t c_poolSize = 1024;
+
+        runner.Run("Pool/AddRemove", 100000, [](uint64_t iterations)
+                   {
+                       static Pool<glm::vec3, c_poolSize> pool;
+                       for (uint64_t i = 0; i < iterations; i++)
+                       {
+                           const size_t index = pool.Add(glm::vec3(float(i)));
+                           pool.Remove(index);
+                       } });
+
+        runner.Run("Pool/Iterate", 100000, [](uint64_t iterations)
+                   {
+                       static Pool<glm::vec3, c_poolSize> pool;
+                       static bool initialized = false;
+                       if (!initialized)
+                       {
+                           // Half full with holes so iteration has to skip inactive slots
+                           for (size_t i = 0; i < c_poolSize; i++)
+                           {
+                               pool.Add(glm::vec3(float(i)));
+                           }
+                           for (size_t i = 0; i < c_poolSize; i += 2)
+                           {
+                               pool.Remove(i);
+                           }
+                           initialized = true;
+                       }
+
+                       glm::vec3 sum = glm::vec3(0.0f);
+                       uint64_t remaining = iterations;
+                       while (remaining > 0)
+                       {
+                           for (auto it = pool.begin(); it != pool.end() && remaining > 0; ++it, remaining--)
+                           {
+                               sum += *it;
+                           }
+                       }
+                       DoNotOptimize(sum); });
+    }
+
+    void RunCoreBenchmarks(Runner &runner)
+    {
+        RunEntityStoreBenchmarks(runner);
+        RunGridBenchmarks(runner);
+        RunEventBusBenchmarks(runner);
+        RunPoolBenchmarks(runner);
+    }
+}
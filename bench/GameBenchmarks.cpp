@@ -0,0 +1,96 @@
+#include "Benchmark.h"
+
+#include "Game/Helpers/ParticleHelper.h"
+#include "Game/Helpers/PerlinNoiseHelper.h"
+#include "Game/Helpers/PhysicsRenderingHelper.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+namespace mk::Bench
+{
+    void RunPerlinNoiseBenchmarks(Runner &runner)
+    {
+        runner.Run("PerlinNoiseHelper/Perlin", 1000000, [](uint64_t iterations)
+                   {
+                       float sum = 0.0f;
+                       for (uint64_t i = 0; i < iterations; i++)
+                       {
+                           sum += PerlinNoiseHelper::Perlin(float(i % 1024) * 0.1f, float(i / 1024) * 0.1f, 42);
+                       }
+                       DoNotOptimize(sum); });
+    }
+
+    template <typename F>
+    void RunParticleBenchmark(Runner &runner, const std::string &name, F &&spawn)
+    {
+        runner.Run("ParticleHelper/" + name, 10000, [&](uint64_t iterations)
+                   {
+                       // Cleared every frame in game, so measure against a reused buffer
+                       std::vector<ParticleEmitJob> particleJobs;
+                       for (uint64_t i = 0; i < iterations; i++)
+                       {
+                           if (i % 64 == 0)
+                           {
+                               particleJobs.clear();
+                           }
+                           spawn(particleJobs, glm::vec3(float(i % 100), 0.0f, 0.0f));
+                       }
+                       DoNotOptimize(particleJobs.size()); });
+    }
+
+    void RunParticleBenchmarks(Runner &runner)
+    {
+        const glm::vec3 direction = glm::vec3(0.0f, 1.0f, 0.0f);
+        const glm::vec4 color = glm::vec4(1.0f, 0.5f, 0.0f, 1.0f);
+
+        RunParticleBenchmark(runner, "SpawnExplosionEffect", [](auto &jobs, const glm::vec3 &position)
+                             { ParticleHelper::SpawnExplosionEffect(jobs, position); });
+        RunParticleBenchmark(runner, "SpawnIceExplosionEffect", [](auto &jobs, const glm::vec3 &position)
+                             { ParticleHelper::SpawnIceExplosionEffect(jobs, position); });
+        RunParticleBenchmark(runner, "SpawnFireExplosionEffect", [](auto &jobs, const glm::vec3 &position)
+                             { ParticleHelper::SpawnFireExplosionEffect(jobs, position); });
+        RunParticleBenchmark(runner, "SpawnGroundImpact", [](auto &jobs, const glm::vec3 &position)
+                             { ParticleHelper::SpawnGroundImpact(jobs, position); });
+        RunParticleBenchmark(runner, "SpawnImpactEffect", [&](auto &jobs, const glm::vec3 &position)
+                             { ParticleHelper::SpawnImpactEffect(jobs, position, direction, color); });
+        RunParticleBenchmark(runner, "SpawnSmokeTrail", [](auto &jobs, const glm::vec3 &position)
+                             { ParticleHelper::SpawnSmokeTrail(jobs, position); });
+        RunParticleBenchmark(runner, "SpawnFireTrail", [](auto &jobs, const glm::vec3 &position)
+                             { ParticleHelper::SpawnFireTrail(jobs, position); });
+        RunParticleBenchmark(runner, "SpawnBloodEffect", [&](auto &jobs, const glm::vec3 &position)
+                             { ParticleHelper::SpawnBloodEffect(jobs, position, direction); });
+        RunParticleBenchmark(runner, "SpawnSpark", [&](auto &jobs, const glm::vec3 &position)
+                             { ParticleHelper::SpawnSpark(jobs, position, color, glm::vec4(0.0f)); });
+        RunParticleBenchmark(runner, "SpawnEmbers", [&](auto &jobs, const glm::vec3 &position)
+                             { ParticleHelper::SpawnEmbers(jobs, position, direction, 100.0f, 200.0f, 1.0f); });
+    }
+
+    // The debug camera view draws every body like this, the null renderer drops the lines
+    void RunPhysicsRenderingBenchmarks(Runner &runner)
+    {
+        Renderer renderer;
+        const CollisionData collisions[] = {
+            {.shape = CapsuleShape(40.0f, 60.0f), .layer = ObjectLayer::Enemy},
+            {.shape = SphereShape(10.0f), .layer = ObjectLayer::PlayerProjectile},
+            {.shape = BoxShape(glm::vec3(50.0f)), .layer = ObjectLayer::NonMoving},
+        };
+
+        runner.Run("PhysicsRenderingHelper/RenderCollision", 100000, [&](uint64_t iterations)
+                   {
+                       for (uint64_t i = 0; i < iterations; i++)
+                       {
+                           const glm::quat rotation = glm::angleAxis(float(i % 360) * 0.01f, glm::vec3(0.0f, 1.0f, 0.0f));
+                           PhysicsRenderingHelper::RenderCollision(renderer, glm::vec3(float(i % 100), 0.0f, 0.0f), rotation, collisions[i % 3]);
+                       }
+                       DoNotOptimize(renderer); });
+    }
+
+    void RunGameBenchmarks(Runner &runner)
+    {
+        RunPerlinNoiseBenchmarks(runner);
+        RunParticleBenchmarks(runner);
+        RunPhysicsRenderingBenchmarks(runner);
+    }
+}
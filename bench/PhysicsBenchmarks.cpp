@@ -0,0 +1,223 @@
+#include "Benchmark.h"
+
+#include "Physics/PhysicsWorld.h"
+
+#include <glm/glm.hpp>
+
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace mk::Bench
+{
+    constexpr float c_physicsTimestep = 1.0f / 60.0f;
+    // Projectiles are released and fired again this often, about the lifetime of a bullet in game
+    constexpr uint64_t c_projectileLifetimeSteps = 60;
+    constexpr uint32_t c_numEnemies = 64;
+    constexpr float c_arenaHalfSize = 4000.0f;
+
+    enum class ProjectileMode
+    {
+        // Pooled bodies on their own projectile layers
+        Bodies,
+        // Pooled bodies with everything moving on ObjectLayer::Moving, which puts them in one broad phase tree
+        // like before projectiles and characters had their own
+        SharedTree,
+        // No bodies, swept with ray casts
+        Raycast,
+    };
+
+    struct ProjectileScene
+    {
+        PhysicsWorld world;
+        ProjectileMode mode;
+        std::vector<ProjectilePoolID> pools;
+        std::vector<BodyID> projectiles;
+        std::vector<glm::vec3> origins;
+        std::vector<glm::vec3> velocities;
+    };
+
+    // Floor, enemies spread over the arena and numProjectiles flying through it, split over both sides
+    void CreateProjectileScene(ProjectileScene &scene, uint32_t numProjectiles, ProjectileMode mode)
+    {
+        const bool sharedTree = mode == ProjectileMode::SharedTree;
+        const uint32_t numPooled = mode == ProjectileMode::Raycast ? 0 : numProjectiles;
+        scene.mode = mode;
+        scene.world.Initialize({.maxBodies = numPooled + c_numEnemies + 64});
+
+        scene.world.CreateRigidBody(
+            {
+                .position = glm::vec3(0.0f, -10.0f, 0.0f),
+                .mass = 0.0f,
+                .shape = BoxShape(glm::vec3(c_arenaHalfSize, 10.0f, c_arenaHalfSize)),
+                .layer = ObjectLayer::NonMoving,
+            },
+            BodyType::Rigidbody);
+
+        std::mt19937 gen(1234);
+        std::uniform_real_distribution<float> position(-c_arenaHalfSize, c_arenaHalfSize);
+        std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+
+        for (uint32_t i = 0; i < c_numEnemies; i++)
+        {
+            scene.world.CreateRigidBody(
+                {
+                    .position = glm::vec3(position(gen), 100.0f, position(gen)),
+                    .gravityFactor = 0.0f,
+                    .shape = BoxShape(glm::vec3(50.0f)),
+                    .layer = sharedTree ? ObjectLayer::Moving : ObjectLayer::Enemy,
+                },
+                BodyType::Rigidbody);
+        }
+
+        scene.pools = {
+            scene.world.GetProjectilePool({.radius = 10.0f, .layer = sharedTree ? ObjectLayer::Moving : ObjectLayer::PlayerProjectile, .capacity = numPooled / 2}),
+            scene.world.GetProjectilePool({.radius = 10.0f, .layer = sharedTree ? ObjectLayer::Moving : ObjectLayer::EnemyProjectile, .capacity = numPooled / 2}),
+        };
+
+        // Bullets fly in the same plane at a fixed height, so they rarely touch each other even on the shared layer
+        for (uint32_t i = 0; i < numProjectiles; i++)
+        {
+            scene.origins.push_back(glm::vec3(position(gen), 100.0f, position(gen)));
+            scene.velocities.push_back(glm::normalize(glm::vec3(direction(gen), 0.0f, direction(gen)) + glm::vec3(0.001f)) * 2000.0f);
+        }
+    }
+
+    void FireProjectiles(ProjectileScene &scene)
+    {
+        for (BodyID id : scene.projectiles)
+        {
+            scene.world.RemoveRigidBody(id);
+        }
+        scene.projectiles.clear();
+
+        for (size_t i = 0; i < scene.origins.size(); i++)
+        {
+            if (scene.mode == ProjectileMode::Raycast)
+            {
+                const ObjectLayer layer = i % 2 == 0 ? ObjectLayer::PlayerProjectile : ObjectLayer::EnemyProjectile;
+                scene.projectiles.push_back(scene.world.CreateRaycastProjectile(layer, scene.origins[i], glm::identity<glm::quat>(), scene.velocities[i]));
+            }
+            else
+            {
+                scene.projectiles.push_back(scene.world.AcquireProjectileBody(scene.pools[i % scene.pools.size()], scene.origins[i], glm::identity<glm::quat>(), scene.velocities[i]));
+            }
+        }
+    }
+
+    void RunProjectileStepBenchmark(Runner &runner, uint32_t numProjectiles, ProjectileMode mode)
+    {
+        // Built on the first call, which is the untimed warm up, and kept stepping across repetitions
+        std::unique_ptr<ProjectileScene> scene;
+        uint64_t step = 0;
+
+        constexpr const char *c_modeSuffixes[] = {"", "SharedTree", "Raycast"};
+        const std::string name = "PhysicsWorld/StepSimulation/" + std::to_string(numProjectiles) + "Projectiles" + c_modeSuffixes[static_cast<size_t>(mode)];
+        runner.Run(name, 600, [&](uint64_t iterations)
+                   {
+                       if (scene == nullptr)
+                       {
+                           scene = std::make_unique<ProjectileScene>();
+                           CreateProjectileScene(*scene, numProjectiles, mode);
+                       }
+
+                       for (uint64_t i = 0; i < iterations; i++, step++)
+                       {
+                           if (step % c_projectileLifetimeSteps == 0)
+                           {
+                               FireProjectiles(*scene);
+                           }
+                           scene->world.StepSimulation(c_physicsTimestep);
+                       }
+                       DoNotOptimize(scene->world.GetStats().numContacts); });
+
+        if (scene != nullptr)
+        {
+            scene->world.Shutdown();
+        }
+    }
+
+    // The per fixed update readback the game does for every awake body
+    void RunStateReadbackBenchmark(Runner &runner, uint32_t numProjectiles)
+    {
+        std::unique_ptr<ProjectileScene> scene;
+        std::vector<RigidBodyState> states(numProjectiles);
+
+        runner.Run("PhysicsWorld/GetRigidBodyStates/" + std::to_string(numProjectiles) + "Projectiles", 10000, [&](uint64_t iterations)
+                   {
+                       if (scene == nullptr)
+                       {
+                           scene = std::make_unique<ProjectileScene>();
+                           CreateProjectileScene(*scene, numProjectiles, ProjectileMode::Bodies);
+                           FireProjectiles(*scene);
+                           scene->world.StepSimulation(c_physicsTimestep);
+                       }
+
+                       for (uint64_t i = 0; i < iterations; i++)
+                       {
+                           scene->world.GetRigidBodyStates(scene->projectiles, states);
+                       }
+                       DoNotOptimize(states[0].position.x); });
+
+        if (scene != nullptr)
+        {
+            scene->world.Shutdown();
+        }
+    }
+
+    // Rollback steps ahead and restores the same snapshot several times per frame
+    void RunSnapshotBenchmark(Runner &runner, uint32_t numProjectiles)
+    {
+        std::unique_ptr<ProjectileScene> scene;
+        PhysicsWorld::Snapshot snapshot;
+
+        runner.Run("PhysicsWorld/StepAndRestoreSnapshot/" + std::to_string(numProjectiles) + "Projectiles", 600, [&](uint64_t iterations)
+                   {
+                       if (scene == nullptr)
+                       {
+                           scene = std::make_unique<ProjectileScene>();
+                           CreateProjectileScene(*scene, numProjectiles, ProjectileMode::Bodies);
+                           FireProjectiles(*scene);
+                           scene->world.StepSimulation(c_physicsTimestep);
+
+                           // A snapshot that is not from this world has to be rejected before anything changes
+                           const uint64_t checksum = scene->world.ComputeChecksum();
+                           if (scene->world.RestoreSnapshot(PhysicsWorld::Snapshot()) || scene->world.ComputeChecksum() != checksum)
+                           {
+                               std::cerr << "RestoreSnapshot changed the world while rejecting a snapshot" << std::endl;
+                           }
+
+                           scene->world.SaveSnapshot(snapshot);
+                       }
+
+                       for (uint64_t i = 0; i < iterations; i++)
+                       {
+                           scene->world.StepSimulation(c_physicsTimestep);
+                           scene->world.RestoreSnapshot(snapshot);
+                       }
+                       DoNotOptimize(scene->world.GetStats().numContacts); });
+
+        if (scene != nullptr)
+        {
+            scene->world.Shutdown();
+        }
+    }
+
+    void RunPhysicsBenchmarks(Runner &runner)
+    {
+        for (uint32_t numProjectiles : {512u, 1024u})
+        {
+            RunProjectileStepBenchmark(runner, numProjectiles, ProjectileMode::Bodies);
+            RunProjectileStepBenchmark(runner, numProjectiles, ProjectileMode::SharedTree);
+            RunProjectileStepBenchmark(runner, numProjectiles, ProjectileMode::Raycast);
+        }
+
+        // Ten times the pooled body counts, only affordable without bodies
+        RunProjectileStepBenchmark(runner, 10240, ProjectileMode::Raycast);
+
+        RunStateReadbackBenchmark(runner, 1024);
+        RunSnapshotBenchmark(runner, 1024);
+    }
+}
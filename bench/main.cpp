@@ -0,0 +1,55 @@
+#include "Benchmark.h"
+
+#include "Core/CmdArgs.h"
+
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+
+// Usage: mk_bench [-filter <substring>] [-repetitions <n>] [-scale <factor>] [-format json|csv] [-out <file>]
+int main(int argc, char **argv)
+{
+    const mk::CmdArgs cmdArgs = mk::CmdArgs::Parse(argc, argv);
+
+    // Better to stop than to measure something else than asked for
+    const std::optional<uint32_t> repetitions = cmdArgs.GetOptionNumber<uint32_t>("-repetitions");
+    const std::optional<double> scale = cmdArgs.GetOptionNumber<double>("-scale");
+    if ((cmdArgs.HasFlag("-repetitions") && !repetitions) || (cmdArgs.HasFlag("-scale") && !scale))
+    {
+        std::cerr << "Usage: mk_bench [-filter <substring>] [-repetitions <n>] [-scale <factor>] [-format json|csv] [-out <file>]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    mk::Bench::Runner runner(cmdArgs.GetOptionValue("-filter"), repetitions.value_or(5), scale.value_or(1.0));
+
+    mk::Bench::RunCoreBenchmarks(runner);
+    mk::Bench::RunGameBenchmarks(runner);
+    mk::Bench::RunPhysicsBenchmarks(runner);
+
+    const std::string format = cmdArgs.GetOptionValue("-format", "json");
+    const std::string outPath = cmdArgs.GetOptionValue("-out");
+
+    std::ofstream file;
+    if (!outPath.empty())
+    {
+        file.open(outPath, std::ios::out | std::ios::app);
+        if (!file.is_open())
+        {
+            std::cerr << "Failed to open benchmark output file: " << outPath << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::ostream &out = file.is_open() ? file : std::cout;
+    if (format == "csv")
+    {
+        runner.WriteCsv(out, MK_VERSION);
+    }
+    else
+    {
+        runner.WriteJson(out, MK_VERSION);
+    }
+
+    return EXIT_SUCCESS;
+}
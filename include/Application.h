@@ -2,20 +2,26 @@
 
 #include "Core/CmdArgs.h"
 #include "Core/EventBus.h"
+#include "Core/FixedStepScheduler.h"
 #include "Game/Game.h"
 #include "Audio/AudioSystem.h"
-#include "Input/InputDevice.h"
 #include "Physics/PhysicsWorld.h"
+#include "Renderer.h"
 
+#ifdef MK_HEADLESS
+#include "Input/InputState.h"
+#else
+#include "Input/InputDevice.h"
 #include "Vultron/Vultron.h"
-#include "Vultron/SceneRenderer.h"
 #include "Vultron/Window.h"
+#endif
 
 #include <cstdint>
 #include <variant>
 #include <vector>
 #include <random>
 #include <future>
+#include <ostream>
 
 using namespace Vultron;
 
@@ -24,8 +30,10 @@ namespace mk
 
     constexpr float c_fixedUpdateInterval = 1.0f / 60.0f;
     constexpr uint32_t c_maxSubSteps = 6;
+    constexpr float c_maxFixedUpdateTime = 1.0f / 20.0f;
 
     constexpr float c_debugInfoUpdateInterval = 1.0f;
+    constexpr float c_memoryLogInterval = 10.0f;
 
     constexpr const char *c_saveFileName = "save.dat";
 
@@ -35,14 +43,43 @@ namespace mk
         float updateTime;
         float renderTime;
         float totalTime;
+        uint32_t fixedSteps;
+        float droppedTime;
+    };
+
+    // Sampled every frame, the byte counts are what is currently reserved rather than what is in use
+    struct MemoryInfo
+    {
+        size_t entityStoreBytes = 0;
+        size_t entityListBytes = 0;
+        size_t physicsTempPeakBytes = 0;
+        size_t physicsTempCapacity = 0;
+        size_t particleJobBytes = 0;
+        uint32_t numParticleJobs = 0;
+        uint32_t numAudioEvents = 0;
+        size_t rendererBytes = 0;
     };
 
+    inline std::ostream &operator<<(std::ostream &out, const MemoryInfo &info)
+    {
+        constexpr float c_kiB = 1.0f / 1024.0f;
+        out << "Memory: entities " << (info.entityStoreBytes + info.entityListBytes) * c_kiB << " KiB"
+            << ", physics temp peak " << info.physicsTempPeakBytes * c_kiB << "/" << info.physicsTempCapacity * c_kiB << " KiB"
+            << ", particle jobs " << info.numParticleJobs << " (" << info.particleJobBytes * c_kiB << " KiB)"
+            << ", audio events " << info.numAudioEvents
+            << ", renderer " << info.rendererBytes * c_kiB << " KiB";
+        return out;
+    }
+
     struct DebugInfo
     {
         float physicsTime;
         float updateTime;
         float renderTime;
         float totalTime;
+        float fixedSteps;
+        float droppedTime;
+        MemoryInfo memory;
     };
 
     class Application
@@ -50,17 +87,23 @@ namespace mk
     private:
         static Application *s_instance;
 
+        // Every random generator in the game is seeded from the session seed, -seed <n> replays a session
         struct
         {
-            std::random_device rd;
+            uint32_t seed;
             std::mt19937 gen;
             std::uniform_real_distribution<float> dis;
         } m_random = {};
 
-        SceneRenderer m_renderer;
+        Renderer m_renderer;
+#ifdef MK_HEADLESS
+        InputState m_inputState;
+        bool m_shouldQuit = false;
+#else
         Window m_window;
-        PhysicsWorld m_physicsWorld;
         InputDevice m_inputDevice;
+#endif
+        PhysicsWorld m_physicsWorld;
         AudioSystem m_audioSystem;
         Game m_game;
         EventBus m_eventBus;
@@ -69,6 +112,13 @@ namespace mk
         CmdArgs m_cmdArgs;
         DebugInfo m_debugInfo;
 
+        FixedStepScheduler m_fixedStepScheduler = FixedStepScheduler({
+            .interval = c_fixedUpdateInterval,
+            .maxStepsPerFrame = c_maxSubSteps,
+            .stepsPerBatch = 1,
+            .maxStepTime = c_maxFixedUpdateTime,
+        });
+
         float m_minUpdateRate = 1.0f / 20.0f;
         double m_maxUpdateRate = 1.0 / 144.0;
         float m_timeSincePhysics = 0.0f;
@@ -77,19 +127,26 @@ namespace mk
         float m_timeSinceStart = 0.0f;
 
         bool Initialize();
+        void InitializeRandom();
         void Shutdown();
         void FixedUpdate(float dt, uint32_t numSubSteps);
         void Update(float dt);
         void Render();
+        void SampleMemoryInfo();
+#ifdef MK_HEADLESS
+        void UpdateScriptedInput(uint64_t tick);
+#endif
 
     public:
         Application() { s_instance = this; }
         ~Application() { s_instance = nullptr; }
 
-        static const SceneRenderer &GetRenderer() { return s_instance->m_renderer; }
+        static const Renderer &GetRenderer() { return s_instance->m_renderer; }
+#ifndef MK_HEADLESS
         static Window &GetWindow() { return s_instance->m_window; }
-        static PhysicsWorld &GetPhysicsWorld() { return s_instance->m_physicsWorld; }
         static InputDevice &GetInputDevice() { return s_instance->m_inputDevice; }
+#endif
+        static PhysicsWorld &GetPhysicsWorld() { return s_instance->m_physicsWorld; }
         static AudioSystem &GetAudioSystem() { return s_instance->m_audioSystem; }
         static EventBus &GetEventBus() { return s_instance->m_eventBus; }
         static Game &GetGame() { return s_instance->m_game; }
@@ -140,6 +197,12 @@ namespace mk
 
         static std::future<void> WritePersistentData()
         {
+#ifdef MK_HEADLESS
+            // Simulation runs must never overwrite the player's save file
+            std::promise<void> promise;
+            promise.set_value();
+            return promise.get_future();
+#else
             return std::async(
                 std::launch::async,
                 []()
@@ -151,12 +214,20 @@ namespace mk
                         file.close();
                     }
                 });
+#endif
         }
 
+#ifdef MK_HEADLESS
+        static void Quit() { s_instance->m_shouldQuit = true; }
+#else
         static void Quit() { s_instance->m_window.SetShouldClose(true); }
+#endif
         static void SetTimeScale(float timeScale) { s_instance->m_timeScale = timeScale; }
 
         static float GetRandomFloat() { return s_instance->m_random.dis(s_instance->m_random.gen); }
+        // Seed for a subsystem's own generator, drawn from the session generator
+        static uint32_t GetRandomSeed() { return s_instance->m_random.gen(); }
+        static uint32_t GetSessionSeed() { return s_instance->m_random.seed; }
 
         uint32_t Run(int argc, char **argv);
     };
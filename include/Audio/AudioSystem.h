@@ -3,7 +3,7 @@
 #include "Core/EnumArray.h"
 
 #include <glm/glm.hpp>
-#include "fmod_studio.hpp"
+#include <glm/gtc/quaternion.hpp>
 
 #include <string>
 #include <map>
@@ -13,6 +13,13 @@
 #undef CreateEvent
 #endif
 
+namespace FMOD::Studio
+{
+    class System;
+    class Bank;
+    class EventInstance;
+}
+
 namespace mk
 {
     enum class BankType
@@ -61,6 +68,8 @@ namespace mk
         void StopAllEvents(bool allowFadeOut = true);
         void ReleaseAllEvents();
 
+        size_t GetNumEvents() const { return m_events.size(); }
+
         void SetListenerState(const glm::vec3 &position, const glm::quat &rotation, const glm::vec3 &velocity);
     };
 }
\ No newline at end of file
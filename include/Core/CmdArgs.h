@@ -4,6 +4,8 @@
 #include <unordered_map>
 #include <vector>
 #include <algorithm>
+#include <charconv>
+#include <iostream>
 #include <optional>
 
 namespace mk
@@ -78,6 +80,28 @@ namespace mk
             return defaultValue;
         }
 
+        // Get the value of an option as a number (e.g., -waves 5). Missing options give nullopt, values that are not
+        // a number or out of range for T give nullopt as well and print an error.
+        template <typename T>
+        std::optional<T> GetOptionNumber(const std::string &option) const
+        {
+            const std::string value = GetOptionValue(option);
+            if (value.empty())
+            {
+                return std::nullopt;
+            }
+
+            T number = {};
+            const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), number);
+            if (error != std::errc() || end != value.data() + value.size())
+            {
+                std::cerr << "Invalid value for " << option << ": " << value << std::endl;
+                return std::nullopt;
+            }
+
+            return number;
+        }
+
         // Get a positional argument (e.g., program_name positional_arg1 positional_arg2)
         std::optional<std::string> GetPositionalArg(size_t index) const
         {
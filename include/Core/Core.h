@@ -14,6 +14,7 @@
 #include <cstdint>
 #include <numeric>
 #include <limits>
+#include <typeinfo>
 
 namespace mk
 {
@@ -7,6 +7,7 @@
 #include <typeindex>
 #include <variant>
 #include <functional>
+#include <cstring>
 
 namespace mk
 {
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+namespace mk
+{
+    struct FixedStepSettings
+    {
+        float interval = 1.0f / 60.0f;
+        // Catch-up budget, whole steps beyond this in a single frame are dropped
+        uint32_t maxStepsPerFrame = 6;
+        // Steps handed to a single update call, 1 runs the fixed systems once per step
+        uint32_t stepsPerBatch = 1;
+        // Wall clock budget in seconds for all steps in a frame, guards against the spiral of death. 0 disables it
+        // so the number of steps only depends on the frame times passed in.
+        float maxStepTime = 1.0f / 20.0f;
+    };
+
+    struct FixedStepStats
+    {
+        uint64_t totalSteps = 0;
+        uint32_t frameSteps = 0;
+        float droppedTime = 0.0f;
+        float totalDroppedTime = 0.0f;
+    };
+
+    class FixedStepScheduler
+    {
+    private:
+        FixedStepSettings m_settings = {};
+        FixedStepStats m_stats = {};
+        float m_accumulator = 0.0f;
+
+    public:
+        FixedStepScheduler() = default;
+        FixedStepScheduler(const FixedStepSettings &settings) : m_settings(settings) {}
+        ~FixedStepScheduler() = default;
+
+        // Adds dt to the accumulator and calls update(stepDt, numSteps) until it is consumed or a budget is hit.
+        // Time that could not be simulated is dropped and reported instead of carried over to the next frame.
+        template <typename F>
+        uint32_t Advance(float dt, F &&update)
+        {
+            using Clock = std::chrono::high_resolution_clock;
+            const auto start = Clock::now();
+
+            m_accumulator += dt;
+            m_stats.frameSteps = 0;
+            m_stats.droppedTime = 0.0f;
+
+            const uint32_t numSteps = std::min(static_cast<uint32_t>(m_accumulator / m_settings.interval), m_settings.maxStepsPerFrame);
+            const uint32_t stepsPerBatch = std::max(m_settings.stepsPerBatch, 1u);
+            while (m_stats.frameSteps < numSteps)
+            {
+                const uint32_t batchSteps = std::min(stepsPerBatch, numSteps - m_stats.frameSteps);
+                update(batchSteps * m_settings.interval, batchSteps);
+                m_stats.frameSteps += batchSteps;
+                m_accumulator -= batchSteps * m_settings.interval;
+
+                if (m_settings.maxStepTime > 0.0f && std::chrono::duration<float>(Clock::now() - start).count() > m_settings.maxStepTime)
+                {
+                    break;
+                }
+            }
+
+            if (m_accumulator >= m_settings.interval)
+            {
+                const float remainder = std::fmod(m_accumulator, m_settings.interval);
+                m_stats.droppedTime = m_accumulator - remainder;
+                m_stats.totalDroppedTime += m_stats.droppedTime;
+                m_accumulator = remainder;
+            }
+
+            m_stats.totalSteps += m_stats.frameSteps;
+            return m_stats.frameSteps;
+        }
+
+        void Reset()
+        {
+            m_accumulator = 0.0f;
+            m_stats = {};
+        }
+
+        // Time accumulated towards the next step, used to interpolate between the last two fixed states
+        float GetAccumulator() const { return m_accumulator; }
+        float GetAlpha() const { return m_accumulator / m_settings.interval; }
+        const FixedStepStats &GetStats() const { return m_stats; }
+        const FixedStepSettings &GetSettings() const { return m_settings; }
+    };
+}
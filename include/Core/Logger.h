@@ -9,6 +9,7 @@
 #include <sstream>
 #include <vector>
 #include <iomanip>
+#include <algorithm>
 #include <optional>
 
 namespace mk
@@ -48,7 +49,6 @@ namespace mk
             return ss.str();
         }
 
-        template <>
         static std::string GetPrintable(const glm::vec2 &value)
         {
             std::stringstream ss;
@@ -56,7 +56,6 @@ namespace mk
             return ss.str();
         }
 
-        template <>
         static std::string GetPrintable(const glm::vec3 &value)
         {
             std::stringstream ss;
@@ -64,7 +63,6 @@ namespace mk
             return ss.str();
         }
 
-        template <>
         static std::string GetPrintable(const glm::vec4 &value)
         {
             std::stringstream ss;
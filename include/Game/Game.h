@@ -1,17 +1,13 @@
 #pragma once
 
 #include "Game/StateMachines/GameStateMachine.h"
+#include "Renderer.h"
 
 #include <fstream>
 #include <cstdint>
 
 #define MK_ASSET_PATH(path) (MK_ASSETS_DIR "/" path)
 
-namespace Vultron
-{
-    class SceneRenderer;
-}
-
 namespace mk
 {
     class AudioSystem;
@@ -52,11 +48,13 @@ namespace mk
         void OnInitialize();
         void OnFixedUpdate(float dt, uint32_t numSteps, PhysicsWorld &physicsWorld);
         void OnUpdate(float dt, AudioSystem &audioSystem, PhysicsWorld &physicsWorld, const InputState &inputState);
-        void OnRender(Vultron::SceneRenderer &renderer);
+        void OnRender(Renderer &renderer);
         void OnShutdown();
 
         void GoToMainMenu();
         void RestartGame();
+
+        const GameStateMachine &GetStateMachine() const { return m_stateMachine; }
     };
 
 }
\ No newline at end of file
@@ -20,6 +20,9 @@ namespace mk::ParticleHelper
         return {size.x * (1.0f / float(numSubAtlas)), size.y};
     }
 
+    // Effects are cosmetic but still seeded from the session, so replays spawn the same particles
+    void Seed(uint32_t seed);
+
     void SpawnExplosionEffect(std::vector<ParticleEmitJob> &particleJobs, const glm::vec3 &position);
     void SpawnIceExplosionEffect(std::vector<ParticleEmitJob> &particleJobs, const glm::vec3 &position);
     void SpawnFireExplosionEffect(std::vector<ParticleEmitJob> &particleJobs, const glm::vec3 &position);
@@ -1,14 +1,10 @@
 #pragma once
 
 #include "Core/StateMachine.h"
+#include "Renderer.h"
 
 #include <future>
 
-namespace Vultron
-{
-    class SceneRenderer;
-}
-
 namespace mk
 {
     class AudioSystem;
@@ -35,6 +31,7 @@ namespace mk
         struct PlayingState
         {
             bool shouldExitGame = false;
+            uint32_t wave = 0;
         };
     }
 
@@ -49,7 +46,7 @@ namespace mk
         static void OnEnter(GameStates::InitialLoadState &state);
         static void OnUpdate(float dt, AudioSystem &audioSystem, PhysicsWorld &physicsWorld, const InputState &inputState, GameStates::InitialLoadState &state);
         static void OnFixedUpdate(float dt, uint32_t numSteps, PhysicsWorld &physicsWorld, GameStates::InitialLoadState &state);
-        static void OnRender(Vultron::SceneRenderer &renderer, GameStates::InitialLoadState &state);
+        static void OnRender(Renderer &renderer, GameStates::InitialLoadState &state);
         static void OnExit(GameStates::InitialLoadState &state);
         static GameStateMachine::OptionalState TransitionTo(const GameStates::InitialLoadState &state);
 
@@ -60,7 +57,7 @@ namespace mk
         static void OnEnter(GameStates::MainMenuState &state);
         static void OnUpdate(float dt, AudioSystem &audioSystem, PhysicsWorld &physicsWorld, const InputState &inputState, GameStates::MainMenuState &state);
         static void OnFixedUpdate(float dt, uint32_t numSteps, PhysicsWorld &physicsWorld, GameStates::MainMenuState &state);
-        static void OnRender(Vultron::SceneRenderer &renderer, GameStates::MainMenuState &state);
+        static void OnRender(Renderer &renderer, GameStates::MainMenuState &state);
         static void OnExit(GameStates::MainMenuState &state);
         static GameStateMachine::OptionalState TransitionTo(const GameStates::MainMenuState &state);
 
@@ -71,7 +68,7 @@ namespace mk
         static void OnEnter(GameStates::LoadingState &state);
         static void OnUpdate(float dt, AudioSystem &audioSystem, PhysicsWorld &physicsWorld, const InputState &inputState, GameStates::LoadingState &state);
         static void OnFixedUpdate(float dt, uint32_t numSteps, PhysicsWorld &physicsWorld, GameStates::LoadingState &state);
-        static void OnRender(Vultron::SceneRenderer &renderer, GameStates::LoadingState &state);
+        static void OnRender(Renderer &renderer, GameStates::LoadingState &state);
         static void OnExit(GameStates::LoadingState &state);
         static GameStateMachine::OptionalState TransitionTo(const GameStates::LoadingState &state);
 
@@ -82,7 +79,7 @@ namespace mk
         static void OnEnter(GameStates::PlayingState &state);
         static void OnUpdate(float dt, AudioSystem &audioSystem, PhysicsWorld &physicsWorld, const InputState &inputState, GameStates::PlayingState &state);
         static void OnFixedUpdate(float dt, uint32_t numSteps, PhysicsWorld &physicsWorld, GameStates::PlayingState &state);
-        static void OnRender(Vultron::SceneRenderer &renderer, GameStates::PlayingState &state);
+        static void OnRender(Renderer &renderer, GameStates::PlayingState &state);
         static void OnExit(GameStates::PlayingState &state);
         static GameStateMachine::OptionalState TransitionTo(const GameStates::PlayingState &state);
 
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "Core/Core.h"
+
+#include "Vultron/SceneRenderer.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace mk
+{
+    // Stand-in for Vultron::SceneRenderer used by the headless build. It mirrors the subset of the
+    // renderer API that game code calls, hands out the same name based handles and drops every render job.
+    class NullRenderer
+    {
+    public:
+        struct Camera
+        {
+            glm::vec3 position = glm::vec3(0.0f);
+            glm::quat rotation = glm::identity<glm::quat>();
+            float fov = 90.0f;
+        };
+
+        struct IrradianceVolume
+        {
+            glm::vec4 min = glm::vec4(0.0f);
+            glm::vec4 max = glm::vec4(0.0f);
+            glm::uvec4 numCells = glm::uvec4(0);
+        };
+
+        struct RenderJob
+        {
+            template <typename... Args>
+            RenderJob(Args &&...) {}
+        };
+
+    private:
+        // Unit cube so that mesh based collision shapes still produce a valid convex hull
+        inline static const std::vector<glm::vec3> c_placeholderVertices = {
+            {-0.5f, -0.5f, -0.5f},
+            {0.5f, -0.5f, -0.5f},
+            {0.5f, 0.5f, -0.5f},
+            {-0.5f, 0.5f, -0.5f},
+            {-0.5f, -0.5f, 0.5f},
+            {0.5f, -0.5f, 0.5f},
+            {0.5f, 0.5f, 0.5f},
+            {-0.5f, 0.5f, 0.5f},
+        };
+
+        inline static const std::vector<uint32_t> c_placeholderIndices = {
+            0, 2, 1, 0, 3, 2, // Back
+            4, 5, 6, 4, 6, 7, // Front
+            0, 1, 5, 0, 5, 4, // Bottom
+            3, 6, 2, 3, 7, 6, // Top
+            0, 4, 7, 0, 7, 3, // Left
+            1, 2, 6, 1, 6, 5, // Right
+        };
+
+    public:
+        NullRenderer() = default;
+        ~NullRenderer() = default;
+
+        template <typename T>
+        RenderHandle CreateMaterial(const std::string &name, const T &material) { return GetHandle(name); }
+
+        RenderHandle LoadImage(const std::string &path) { return GetHandle(path); }
+        RenderHandle LoadImage(const std::string &path, ImageType type, bool generateMipMaps = false) { return GetHandle(path); }
+        RenderHandle LoadMesh(const std::string &path, bool keepVertices = false) { return GetHandle(path); }
+        RenderHandle LoadFontAtlas(const std::string &path) { return GetHandle(path); }
+        RenderHandle LoadEnvironmentMap(const std::string &name, const std::string &irradiancePath, const std::string &prefilteredPath, const IrradianceVolume &volume, const std::vector<glm::vec3> &probePositions) { return GetHandle(name); }
+
+        const std::vector<glm::vec3> &GetMeshVertices(RenderHandle mesh) const { return c_placeholderVertices; }
+        const std::vector<uint32_t> &GetMeshIndices(RenderHandle mesh) const { return c_placeholderIndices; }
+        std::vector<FontGlyph> GetTextGlyphs(RenderHandle fontAtlas, const std::string &text) const { return {}; }
+        FontGlyph GetGlyph(RenderHandle fontAtlas, const std::string &character) const { return {}; }
+        float GetAspectRatio() const { return 16.0f / 9.0f; }
+        size_t GetMemoryUsage() const { return 0; }
+
+        void SubmitRenderJob(const RenderJob &job) {}
+        void SetCamera(const Camera &camera) {}
+        template <typename T>
+        void SetPointLights(const T &pointLights) {}
+        void SetDeltaTime(float dt) {}
+        void SetParticleAtlasMaterial(RenderHandle material) {}
+        void SetEnvironmentMap(const std::optional<RenderHandle> &environmentMap) {}
+        void SetSkybox(const std::optional<RenderHandle> &skybox) {}
+    };
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <bitset>
+#include <cstdint>
+
+namespace mk
+{
+    enum class InputActionType
+    {
+        Aim,
+        Attack,
+        Jump,
+        Dash,
+        Reload,
+        Escape,
+
+        Option1,
+        Option2,
+        Option3,
+        Option4,
+        Option5,
+        Option6,
+
+        NextOption,
+        PreviousOption,
+
+        AnyKey,
+
+        DebugOption1,
+        DebugOption2,
+        DebugOption3,
+        DebugOption4,
+        DebugOption5,
+        DebugOption6,
+        DebugOption7,
+
+        Count,
+        None
+    };
+
+    constexpr uint32_t c_numInputActions = static_cast<uint32_t>(InputActionType::Count);
+    constexpr uint32_t c_numOptions = static_cast<uint32_t>(InputActionType::Option6) - static_cast<uint32_t>(InputActionType::Option1) + 1;
+    constexpr uint32_t c_numDebugOptions = static_cast<uint32_t>(InputActionType::DebugOption7) - static_cast<uint32_t>(InputActionType::DebugOption1) + 1;
+
+    struct InputState
+    {
+        glm::vec2 movementAxis = {};
+        glm::vec2 lookAxis = {};
+        std::bitset<c_numInputActions> actions = {};
+        std::bitset<c_numInputActions> beginActions = {};
+        std::bitset<c_numInputActions> endActions = {};
+
+        bool usingGamepad = false;
+
+        void Reset()
+        {
+            movementAxis = {};
+            lookAxis = {};
+            actions.reset();
+            beginActions.reset();
+            endActions.reset();
+            usingGamepad = false;
+        }
+
+        template <typename T>
+        bool Pressed(T action, uint32_t index = 0) const
+        {
+            const uint32_t actionIndex = static_cast<uint32_t>(action) + index;
+            return beginActions[actionIndex];
+        }
+
+        template <typename T>
+        bool Released(T action, uint32_t index = 0) const
+        {
+            const uint32_t actionIndex = static_cast<uint32_t>(action) + index;
+            return endActions[actionIndex];
+        }
+
+        template <typename T>
+        bool Down(T action, uint32_t index = 0) const
+        {
+            const uint32_t actionIndex = static_cast<uint32_t>(action) + index;
+            return actions[actionIndex];
+        }
+
+        template <typename T>
+        void Set(bool value, T action, uint32_t index = 0)
+        {
+            const uint32_t actionIndex = static_cast<uint32_t>(action) + index;
+            actions.set(actionIndex, value);
+        }
+
+        template <typename T>
+        void OrSet(bool value, T action, uint32_t index = 0)
+        {
+            const uint32_t actionIndex = static_cast<uint32_t>(action) + index;
+            actions.set(actionIndex, actions[actionIndex] || value);
+        }
+    };
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Jolt/Jolt.h"
+#include "Jolt/Core/TempAllocator.h"
+
+#include <algorithm>
+
+namespace mk
+{
+    // Jolt's stack allocator with usage tracking. Everything is freed again at the end of a step,
+    // so the peak is what tells how close the simulation gets to running out of temp memory.
+    class TrackingTempAllocator final : public JPH::TempAllocator
+    {
+    private:
+        JPH::TempAllocatorImpl m_allocator;
+        JPH::uint m_size = 0;
+        JPH::uint m_usage = 0;
+        JPH::uint m_peakUsage = 0;
+
+    public:
+        explicit TrackingTempAllocator(JPH::uint size)
+            : m_allocator(size), m_size(size) {}
+        ~TrackingTempAllocator() override = default;
+
+        void *Allocate(JPH::uint inSize) override
+        {
+            m_usage += inSize;
+            m_peakUsage = std::max(m_peakUsage, m_usage);
+            return m_allocator.Allocate(inSize);
+        }
+
+        void Free(void *inAddress, JPH::uint inSize) override
+        {
+            m_usage -= inSize;
+            m_allocator.Free(inAddress, inSize);
+        }
+
+        JPH::uint GetSize() const { return m_size; }
+        JPH::uint GetUsage() const { return m_usage; }
+        JPH::uint GetPeakUsage() const { return m_peakUsage; }
+        void ResetPeakUsage() { m_peakUsage = m_usage; }
+    };
+}
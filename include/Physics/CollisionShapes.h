@@ -9,6 +9,7 @@
 #include "Jolt/Physics/Collision/Shape/MeshShape.h"
 #include "Jolt/Physics/Collision/Shape/ConvexHullShape.h"
 
+#include <memory>
 #include <variant>
 #include <optional>
 #include <cassert>
@@ -89,47 +90,101 @@ namespace mk
     class MeshShape
     {
     private:
-        // Not the best to copy here but we need to store them for debug rendering
-        std::vector<glm::vec3> m_vertices;
-        std::vector<uint32_t> m_indices;
+        // Shared between copies, so bodies, settings and debug rendering all reference one set of vertices
+        // and the convex hull is only built the first time a body is created from it
+        struct Data
+        {
+            std::vector<glm::vec3> vertices;
+            std::vector<uint32_t> indices;
+            JPH::ShapeRefC shape;
+        };
+
+        std::shared_ptr<Data> m_data;
 
     public:
         MeshShape(const std::vector<glm::vec3> &vertices, const std::vector<uint32_t> &indices, const glm::mat4 &transform)
-            : m_indices(indices)
+            : m_data(std::make_shared<Data>())
         {
-            m_vertices.reserve(vertices.size());
+            m_data->indices = indices;
+            m_data->vertices.reserve(vertices.size());
             for (const auto &vertex : vertices)
             {
                 glm::vec3 newVertex = glm::vec3(transform * glm::vec4(vertex, 1.0f));
-                m_vertices.push_back(newVertex);
+                m_data->vertices.push_back(newVertex);
             }
         }
         MeshShape(const std::vector<glm::vec3> &vertices, const std::vector<uint32_t> &indices)
-            : m_vertices(vertices), m_indices(indices) {}
+            : m_data(std::make_shared<Data>(Data{vertices, indices, nullptr})) {}
         MeshShape() = default;
         ~MeshShape() = default;
 
-        const std::vector<glm::vec3> &GetVertices() const { return m_vertices; }
-        const std::vector<uint32_t> &GetIndices() const { return m_indices; }
+        const std::vector<glm::vec3> &GetVertices() const
+        {
+            static const std::vector<glm::vec3> empty = {};
+            return m_data != nullptr ? m_data->vertices : empty;
+        }
+
+        const std::vector<uint32_t> &GetIndices() const
+        {
+            static const std::vector<uint32_t> empty = {};
+            return m_data != nullptr ? m_data->indices : empty;
+        }
+
+        // Identifies the data shared between copies, as a cache key that notices when the data is freed
+        std::weak_ptr<const void> GetDataHandle() const { return m_data; }
+
+        // Uses a prebuilt shape, e.g. a baked one, instead of building a hull from the vertices
+        void SetShape(const JPH::ShapeRefC &shape)
+        {
+            assert(m_data != nullptr && "Mesh shape has no data");
+            m_data->shape = shape;
+        }
 
         JPH::ShapeSettings::ShapeResult GetShapeSettings() const
         {
+            assert(m_data != nullptr && "Mesh shape has no data");
+
+            JPH::ShapeSettings::ShapeResult result;
+            if (m_data->shape != nullptr)
+            {
+                result.Set(m_data->shape);
+                return result;
+            }
+
             JPH::ConvexHullShapeSettings settings;
-            settings.mPoints.reserve(m_vertices.size());
-            for (const auto &vertex : m_vertices)
+            settings.mPoints.reserve(m_data->vertices.size());
+            for (const auto &vertex : m_data->vertices)
             {
                 settings.mPoints.push_back(JoltHelpers::ConvertWithUnits(vertex));
             }
-            auto result = settings.Create();
+            result = settings.Create();
             if (!result.IsValid())
             {
                 std::cerr << result.GetError() << std::endl;
                 abort();
             }
+            m_data->shape = result.Get();
             return result;
         }
     };
 
+    // Same order as the CollisionShape variant
+    enum class CollisionShapeType : uint32_t
+    {
+        Sphere,
+        Box,
+        Capsule,
+        Mesh,
+
+        Count,
+        None,
+    };
+
     using CollisionShape = std::variant<SphereShape, BoxShape, CapsuleShape, MeshShape>;
     using OptionalCollisionShape = std::optional<CollisionShape>;
+
+    inline CollisionShapeType GetCollisionShapeType(const CollisionShape &shape)
+    {
+        return static_cast<CollisionShapeType>(shape.index());
+    }
 }
\ No newline at end of file
@@ -4,7 +4,10 @@
 #include <glm/gtc/quaternion.hpp>
 #include "Jolt/Jolt.h"
 
+#include <cassert>
+#include <cstddef>
 #include <cstdint>
+#include <span>
 
 namespace mk::JoltHelpers
 {
@@ -42,6 +45,73 @@ namespace mk::JoltHelpers
         return JPH::Quat(inQuat.x, inQuat.y, inQuat.z, inQuat.w);
     }
 
+    // glm::vec3 and glm::quat share the layout of JPH::Float3 and JPH::Float4, so the helpers below load and store
+    // them straight from Jolt's SIMD registers and scale there instead of going through GetX/GetY/GetZ
+    static_assert(sizeof(glm::vec3) == sizeof(JPH::Float3), "glm::vec3 must be three packed floats");
+    static_assert(sizeof(glm::quat) == sizeof(JPH::Float4) && offsetof(glm::quat, x) == 0 && offsetof(glm::quat, w) == 12, "glm::quat must be stored as xyzw");
+
+    inline void StoreWithUnits(JPH::Vec3Arg inVec, glm::vec3 &outVec)
+    {
+        (inVec * spaceScale).StoreFloat3(reinterpret_cast<JPH::Float3 *>(&outVec));
+    }
+
+    inline void Store(JPH::Vec3Arg inVec, glm::vec3 &outVec)
+    {
+        inVec.StoreFloat3(reinterpret_cast<JPH::Float3 *>(&outVec));
+    }
+
+    inline void Store(JPH::QuatArg inQuat, glm::quat &outQuat)
+    {
+        inQuat.GetXYZW().StoreFloat4(reinterpret_cast<JPH::Float4 *>(&outQuat));
+    }
+
+    // Batch versions for readbacks gathered into contiguous Jolt arrays, writing one member of each output struct
+    template <typename T>
+    inline void StoreWithUnits(std::span<const JPH::Vec3> inVecs, std::span<T> outValues, glm::vec3 T::*member)
+    {
+        assert(outValues.size() >= inVecs.size());
+        for (size_t i = 0; i < inVecs.size(); i++)
+        {
+            StoreWithUnits(inVecs[i], outValues[i].*member);
+        }
+    }
+
+    template <typename T>
+    inline void Store(std::span<const JPH::Vec3> inVecs, std::span<T> outValues, glm::vec3 T::*member)
+    {
+        assert(outValues.size() >= inVecs.size());
+        for (size_t i = 0; i < inVecs.size(); i++)
+        {
+            Store(inVecs[i], outValues[i].*member);
+        }
+    }
+
+    template <typename T>
+    inline void Store(std::span<const JPH::Quat> inQuats, std::span<T> outValues, glm::quat T::*member)
+    {
+        assert(outValues.size() >= inQuats.size());
+        for (size_t i = 0; i < inQuats.size(); i++)
+        {
+            Store(inQuats[i], outValues[i].*member);
+        }
+    }
+
+    // The w component is ignored, used for the glm::vec4 payload of queued body commands
+    inline JPH::Vec3 LoadWithUnits(const glm::vec4 &inVec)
+    {
+        return JPH::Vec3(JPH::Vec4::sLoadFloat4(reinterpret_cast<const JPH::Float4 *>(&inVec)) * spaceScaleInv);
+    }
+
+    inline JPH::Vec3 Load(const glm::vec4 &inVec)
+    {
+        return JPH::Vec3(JPH::Vec4::sLoadFloat4(reinterpret_cast<const JPH::Float4 *>(&inVec)));
+    }
+
+    inline JPH::Quat LoadQuat(const glm::vec4 &inXYZW)
+    {
+        return JPH::Quat(JPH::Vec4::sLoadFloat4(reinterpret_cast<const JPH::Float4 *>(&inXYZW)));
+    }
+
     inline float ToJolt(float inValue)
     {
         return inValue * spaceScaleInv;
@@ -22,8 +22,9 @@ namespace mk
         static constexpr JPH::ObjectLayer ENEMY = 3;
         static constexpr JPH::ObjectLayer PLAYER_PROJECTILE = 4;
         static constexpr JPH::ObjectLayer ENEMY_PROJECTILE = 5;
+        static constexpr JPH::ObjectLayer DEBRIS = 6;
 
-        static constexpr JPH::ObjectLayer NUM_LAYERS = 6;
+        static constexpr JPH::ObjectLayer NUM_LAYERS = 7;
     };
 
     /// Class that determines if two object layers can collide
@@ -38,11 +39,19 @@ namespace mk
     // You can have a 1-on-1 mapping between object layers and broadphase layers (like in this case) but if you have
     // many object layers you'll be creating many broad phase trees, which is not efficient. If you want to fine tune
     // your broadphase layers define JPH_TRACK_BROADPHASE_STATS and look at the stats reported on the TTY.
+    // Characters and each side's projectiles get their own tree, projectiles are many, fast and short lived and would
+    // otherwise keep rebuilding the tree the player and enemies live in. A projectile never collides with its own side,
+    // so splitting them by side lets them skip the tree that holds most of the other projectiles. Debris only rests
+    // on the level, nothing else has to look in its tree.
     namespace BroadPhaseLayers
     {
         static constexpr JPH::BroadPhaseLayer NON_MOVING(0);
         static constexpr JPH::BroadPhaseLayer MOVING(1);
-        static constexpr JPH::uint NUM_LAYERS(2);
+        static constexpr JPH::BroadPhaseLayer CHARACTER(2);
+        static constexpr JPH::BroadPhaseLayer PLAYER_PROJECTILE(3);
+        static constexpr JPH::BroadPhaseLayer ENEMY_PROJECTILE(4);
+        static constexpr JPH::BroadPhaseLayer DEBRIS(5);
+        static constexpr JPH::uint NUM_LAYERS(6);
     };
 
     // BroadPhaseLayerInterface implementation
@@ -55,6 +64,11 @@ namespace mk
             // Create a mapping table from object to broad phase layer
             mObjectToBroadPhase[Layers::NON_MOVING] = BroadPhaseLayers::NON_MOVING;
             mObjectToBroadPhase[Layers::MOVING] = BroadPhaseLayers::MOVING;
+            mObjectToBroadPhase[Layers::PLAYER] = BroadPhaseLayers::CHARACTER;
+            mObjectToBroadPhase[Layers::ENEMY] = BroadPhaseLayers::CHARACTER;
+            mObjectToBroadPhase[Layers::PLAYER_PROJECTILE] = BroadPhaseLayers::PLAYER_PROJECTILE;
+            mObjectToBroadPhase[Layers::ENEMY_PROJECTILE] = BroadPhaseLayers::ENEMY_PROJECTILE;
+            mObjectToBroadPhase[Layers::DEBRIS] = BroadPhaseLayers::DEBRIS;
         }
 
         virtual JPH::uint GetNumBroadPhaseLayers() const override
@@ -65,7 +79,6 @@ namespace mk
         virtual JPH::BroadPhaseLayer GetBroadPhaseLayer(JPH::ObjectLayer inLayer) const override
         {
             JPH_ASSERT(inLayer < Layers::NUM_LAYERS);
-            inLayer = inLayer > Layers::MOVING ? Layers::MOVING : inLayer;
             return mObjectToBroadPhase[inLayer];
         }
 
@@ -78,6 +91,14 @@ namespace mk
                 return "NON_MOVING";
             case (JPH::BroadPhaseLayer::Type)BroadPhaseLayers::MOVING:
                 return "MOVING";
+            case (JPH::BroadPhaseLayer::Type)BroadPhaseLayers::CHARACTER:
+                return "CHARACTER";
+            case (JPH::BroadPhaseLayer::Type)BroadPhaseLayers::PLAYER_PROJECTILE:
+                return "PLAYER_PROJECTILE";
+            case (JPH::BroadPhaseLayer::Type)BroadPhaseLayers::ENEMY_PROJECTILE:
+                return "ENEMY_PROJECTILE";
+            case (JPH::BroadPhaseLayer::Type)BroadPhaseLayers::DEBRIS:
+                return "DEBRIS";
             default:
                 JPH_ASSERT(false);
                 return "INVALID";
@@ -86,7 +107,7 @@ namespace mk
 #endif // JPH_EXTERNAL_PROFILE || JPH_PROFILE_ENABLED
 
     private:
-        JPH::BroadPhaseLayer mObjectToBroadPhase[2];
+        JPH::BroadPhaseLayer mObjectToBroadPhase[Layers::NUM_LAYERS];
     };
 
     /// Class that determines if an object layer can collide with a broadphase layer
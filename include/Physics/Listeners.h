@@ -1,12 +1,21 @@
 #pragma once
 
 #include "Physics/Types.h"
+#include "Physics/Helpers.h"
 
 #include "Jolt/Jolt.h"
 #include "Jolt/Physics/Body/BodyActivationListener.h"
+#include "Jolt/Physics/Collision/ContactListener.h"
 
-#include <set>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <span>
+#include <tuple>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace mk
@@ -24,8 +33,27 @@ namespace mk
         float penetration;
     };
 
+    enum class ContactEventType : uint8_t
+    {
+        Begin,
+        Persist,
+        End,
+
+        Count,
+        None,
+    };
+
+    // Same key for both orders of a pair
+    inline uint64_t GetPairKey(BodyID body1, BodyID body2)
+    {
+        return body1 < body2 ? (uint64_t(body1) << 32) | body2 : (uint64_t(body2) << 32) | body1;
+    }
+
+    // One event per touching sub shape pair, End events only carry the bodies and key since the contact is gone
     struct PairContact
     {
+        uint64_t key;
+        ContactEventType type;
         BodyID body1;
         BodyID body2;
         glm::vec3 position;
@@ -33,15 +61,165 @@ namespace mk
         float penetration;
     };
 
+    // Contacts are recorded from Jolt's worker threads into per-thread buffers without locking and
+    // merged into one array sorted by body after the step, GetContacts returns a slice of that array.
     class ContactListener : public JPH::ContactListener
     {
     private:
-        // Bodies we listen to contact events for:
-        std::set<BodyID> m_listeningBodies;
-        std::unordered_map<BodyID, std::vector<Contact>> m_contacts = {};
-        std::mutex m_mutex;
+        static constexpr size_t c_numListeningWords = (c_bodyIndexMask + 1) / 64;
+
+        struct OwnedContact
+        {
+            BodyID owner;
+            Contact contact;
+        };
+
+        // Pair event as reported by Jolt, keyed by its sub shape pair since removals only know that
+        struct RawPairEvent
+        {
+            uint64_t subShapeKey;
+            PairContact contact;
+        };
+
+        // Fixed capacity list over storage owned by the listener, appending never allocates
+        template <typename T>
+        struct FixedBuffer
+        {
+            T *data = nullptr;
+            uint32_t capacity = 0;
+            uint32_t size = 0;
+
+            bool HasRoom(uint32_t count) const { return size + count <= capacity; }
+
+            bool Push(const T &value)
+            {
+                if (size == capacity)
+                    return false;
+
+                data[size++] = value;
+                return true;
+            }
+
+            std::span<const T> Get() const { return std::span<const T>(data, size); }
+        };
+
+        // Padded to a cache line so threads appending to neighbouring buffers do not share one
+        struct alignas(64) ThreadBuffer
+        {
+            FixedBuffer<OwnedContact> contacts;
+            FixedBuffer<RawPairEvent> pairEvents;
+            uint32_t numManifolds = 0;
+            // Contacts and pair events that did not fit
+            uint32_t numDropped = 0;
+        };
+
+        struct ActivePair
+        {
+            uint64_t subShapeKey;
+            BodyID body1;
+            BodyID body2;
+        };
+
+        // Bodies we listen to contact events for, one bit per body slot
+        std::array<uint64_t, c_numListeningWords> m_listening = {};
+
+        // Buffer of the calling thread, see SetThreadIndex
+        static inline thread_local uint32_t t_threadIndex = 0;
+
+        // One buffer per thread of the job system plus the stepping thread, all carved out of the storage below
+        std::vector<ThreadBuffer> m_threadBuffers;
+        std::vector<OwnedContact> m_contactStorage;
+        std::vector<RawPairEvent> m_pairEventStorage;
+        // Reports from threads without a buffer, e.g. from a job system that was started with more threads later
+        std::atomic<uint32_t> m_numUnbuffered = 0;
+
+        // Merged contacts, m_contactOwners[i] is the body that m_contacts[i] belongs to
+        std::vector<BodyID> m_contactOwners;
+        std::vector<Contact> m_contacts;
+        std::vector<OwnedContact> m_mergeBuffer;
+
+        // Pair events of the current frame in one flat stream, plus the bodies of every sub shape pair
+        // that is touching so End events can be resolved
+        std::vector<PairContact> m_pairContacts;
+        std::vector<RawPairEvent> m_pairMergeBuffer;
+        // Sorted by sub shape key, flat so that snapshots save and restore it into their existing capacity
+        std::vector<ActivePair> m_activePairs;
+
+        // All manifolds added or persisted in the last step, listened to or not
+        uint32_t m_numManifolds = 0;
+        // Contacts and pair events dropped in the last step because a thread buffer was full
+        uint32_t m_numDropped = 0;
+
+        bool IsListening(BodyID id) const
+        {
+            const uint32_t index = GetBodyIndex(id);
+            return (m_listening[index >> 6] >> (index & 63)) & 1;
+        }
+
+        // Returns nullptr and counts the report as dropped if the thread has no buffer
+        ThreadBuffer *GetThreadBuffer()
+        {
+            if (t_threadIndex < m_threadBuffers.size())
+                return &m_threadBuffers[t_threadIndex];
+
+            m_numUnbuffered.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        // Returns false if neither body is listened to
+        bool AddPairEvent(ContactEventType type, const JPH::Body &inBody1, const JPH::Body &inBody2, const JPH::ContactManifold &inManifold, ThreadBuffer &buffer)
+        {
+            uint64_t bodyRawData1 = inBody1.GetUserData();
+            uint64_t bodyRawData2 = inBody2.GetUserData();
+            const BodyID bodyId1 = reinterpret_cast<UserData *>(&bodyRawData1)->id;
+            const BodyID bodyId2 = reinterpret_cast<UserData *>(&bodyRawData2)->id;
+
+            if (!IsListening(bodyId1) && !IsListening(bodyId2))
+            {
+                return false;
+            }
+
+            const JPH::SubShapeIDPair subShapePair(inBody1.GetID(), inManifold.mSubShapeID1, inBody2.GetID(), inManifold.mSubShapeID2);
+            const bool added = buffer.pairEvents.Push({
+                subShapePair.GetHash(),
+                PairContact{
+                    GetPairKey(bodyId1, bodyId2),
+                    type,
+                    bodyId1,
+                    bodyId2,
+                    JoltHelpers::ConvertWithUnits(inManifold.mBaseOffset),
+                    JoltHelpers::Convert(inManifold.mWorldSpaceNormal),
+                    JoltHelpers::FromJolt(inManifold.mPenetrationDepth),
+                },
+            });
+            if (!added)
+            {
+                buffer.numDropped++;
+            }
+            return true;
+        }
 
     public:
+        // Buffer index of the calling thread: 0 for the thread that steps the world, 1 + the worker index for
+        // the job system's workers, which set it once when they start
+        static void SetThreadIndex(uint32_t index) { t_threadIndex = index; }
+
+        // Allocates all buffers up front, numThreads counts the stepping thread. Call before the first step.
+        void Initialize(uint32_t numThreads, uint32_t capacityPerThread)
+        {
+            m_contactStorage.assign(size_t(numThreads) * capacityPerThread, {});
+            m_pairEventStorage.assign(size_t(numThreads) * capacityPerThread, {});
+            m_threadBuffers = std::vector<ThreadBuffer>(numThreads);
+            for (uint32_t i = 0; i < numThreads; i++)
+            {
+                ThreadBuffer &buffer = m_threadBuffers[i];
+                buffer.contacts = {m_contactStorage.data() + size_t(i) * capacityPerThread, capacityPerThread, 0};
+                buffer.pairEvents = {m_pairEventStorage.data() + size_t(i) * capacityPerThread, capacityPerThread, 0};
+            }
+
+            m_activePairs.reserve(capacityPerThread);
+        }
+
         // See: ContactListener
         virtual JPH::ValidateResult OnContactValidate(const JPH::Body &inBody1, const JPH::Body &inBody2, JPH::RVec3Arg inBaseOffset, const JPH::CollideShapeResult &inCollisionResult) override
         {
@@ -61,68 +239,240 @@ namespace mk
             BodyID bodyId1 = body1Data.id;
             BodyID bodyId2 = body2Data.id;
 
-            if (m_listeningBodies.find(bodyId1) == m_listeningBodies.end() && m_listeningBodies.find(bodyId2) == m_listeningBodies.end())
+            ThreadBuffer *buffer = GetThreadBuffer();
+            if (buffer == nullptr)
+                return;
+
+            buffer->numManifolds++;
+            if (!AddPairEvent(ContactEventType::Begin, inBody1, inBody2, inManifold, *buffer))
             {
                 return;
             }
 
+            // Both sides or neither, so a body never sees a contact the other one does not
+            if (!buffer->contacts.HasRoom(2))
+            {
+                buffer->numDropped += 2;
+                return;
+            }
+
             auto position = JoltHelpers::ConvertWithUnits(inManifold.mBaseOffset);
             auto normal = JoltHelpers::Convert(inManifold.mWorldSpaceNormal);
             auto penetration = JoltHelpers::FromJolt(inManifold.mPenetrationDepth);
 
-            m_mutex.lock();
+            buffer->contacts.Push({bodyId1, Contact{bodyId2, body2Data.data, ObjectLayer(inBody2.GetObjectLayer()), position, normal, penetration}});
+            buffer->contacts.Push({bodyId2, Contact{bodyId1, body1Data.data, ObjectLayer(inBody1.GetObjectLayer()), position, -normal, penetration}});
+        }
 
-            if (m_contacts.find(bodyId1) == m_contacts.end())
-            {
-                m_contacts[bodyId1] = std::vector<Contact>();
-            }
+        virtual void OnContactPersisted(const JPH::Body &inBody1, const JPH::Body &inBody2, const JPH::ContactManifold &inManifold, JPH::ContactSettings &ioSettings) override
+        {
+            ThreadBuffer *buffer = GetThreadBuffer();
+            if (buffer == nullptr)
+                return;
+
+            buffer->numManifolds++;
+            AddPairEvent(ContactEventType::Persist, inBody1, inBody2, inManifold, *buffer);
+        }
 
-            if (m_contacts.find(bodyId2) == m_contacts.end())
+        virtual void OnContactRemoved(const JPH::SubShapeIDPair &inSubShapePair) override
+        {
+            // The bodies may already be gone, they are resolved from the active pairs when merging
+            ThreadBuffer *buffer = GetThreadBuffer();
+            if (buffer != nullptr && !buffer->pairEvents.Push({inSubShapePair.GetHash(), PairContact{0, ContactEventType::End, c_invalidBodyID, c_invalidBodyID, glm::vec3(0.0f), glm::vec3(0.0f), 0.0f}}))
             {
-                m_contacts[bodyId2] = std::vector<Contact>();
+                buffer->numDropped++;
             }
-
-            m_contacts[bodyId1].emplace_back(Contact{bodyId2, body2Data.data, ObjectLayer(inBody2.GetObjectLayer()), position, normal, penetration});
-            m_contacts[bodyId2].emplace_back(Contact{bodyId1, body1Data.data, ObjectLayer(inBody1.GetObjectLayer()), position, -normal, penetration});
-
-            m_mutex.unlock();
         }
 
-        virtual void OnContactPersisted(const JPH::Body &inBody1, const JPH::Body &inBody2, const JPH::ContactManifold &inManifold, JPH::ContactSettings &ioSettings) override
+        // Contacts found outside of Jolt's step, like raycast projectile hits, picked up by the next MergeContacts.
+        // Safe to call from jobs, dropped if the owner is not listened to.
+        void AddContact(BodyID owner, const Contact &contact)
         {
+            if (!IsListening(owner))
+                return;
+
+            ThreadBuffer *buffer = GetThreadBuffer();
+            if (buffer != nullptr && !buffer->contacts.Push({owner, contact}))
+            {
+                buffer->numDropped++;
+            }
         }
 
-        virtual void OnContactRemoved(const JPH::SubShapeIDPair &inSubShapePair) override
+        void Register(BodyID bodyId)
         {
+            const uint32_t index = GetBodyIndex(bodyId);
+            m_listening[index >> 6] |= uint64_t(1) << (index & 63);
         }
 
-        const void Register(BodyID bodyId)
+        void Unregister(BodyID bodyId)
         {
-            m_listeningBodies.insert(bodyId);
+            const uint32_t index = GetBodyIndex(bodyId);
+            m_listening[index >> 6] &= ~(uint64_t(1) << (index & 63));
         }
 
-        const void Unregister(BodyID bodyId)
+        // Called after each step, on the simulating thread once the workers are done
+        void MergeContacts()
         {
-            m_listeningBodies.erase(bodyId);
+            MergePairEvents();
+
+            m_numManifolds = 0;
+            m_numDropped = m_numUnbuffered.exchange(0, std::memory_order_relaxed);
+            size_t numNew = 0;
+            for (ThreadBuffer &buffer : m_threadBuffers)
+            {
+                m_numManifolds += buffer.numManifolds;
+                m_numDropped += buffer.numDropped;
+                buffer.numManifolds = 0;
+                buffer.numDropped = 0;
+                numNew += buffer.contacts.size;
+            }
+
+            if (numNew == 0)
+                return;
+
+            m_mergeBuffer.clear();
+            m_mergeBuffer.reserve(m_contacts.size() + numNew);
+            for (size_t i = 0; i < m_contacts.size(); i++)
+            {
+                m_mergeBuffer.push_back({m_contactOwners[i], m_contacts[i]});
+            }
+
+            for (ThreadBuffer &buffer : m_threadBuffers)
+            {
+                const std::span<const OwnedContact> contacts = buffer.contacts.Get();
+                m_mergeBuffer.insert(m_mergeBuffer.end(), contacts.begin(), contacts.end());
+                buffer.contacts.size = 0;
+            }
+
+            // Sorting by the other body as well makes the order independent of which thread found the contact
+            // Ties are broken by position, so the order does not depend on which thread reported a contact first
+            std::sort(m_mergeBuffer.begin(), m_mergeBuffer.end(), [](const OwnedContact &a, const OwnedContact &b)
+                      { return std::tie(a.owner, a.contact.body, a.contact.position.x, a.contact.position.y, a.contact.position.z) <
+                               std::tie(b.owner, b.contact.body, b.contact.position.x, b.contact.position.y, b.contact.position.z); });
+
+            m_contactOwners.resize(m_mergeBuffer.size());
+            m_contacts.resize(m_mergeBuffer.size());
+            for (size_t i = 0; i < m_mergeBuffer.size(); i++)
+            {
+                m_contactOwners[i] = m_mergeBuffer[i].owner;
+                m_contacts[i] = m_mergeBuffer[i].contact;
+            }
         }
 
-        const std::vector<Contact> &GetContacts(BodyID bodyId) const
+        void MergePairEvents()
         {
-            static std::vector<Contact> empty = {};
-            auto it = m_contacts.find(bodyId);
-            if (it != m_contacts.end())
+            m_pairMergeBuffer.clear();
+            for (ThreadBuffer &buffer : m_threadBuffers)
+            {
+                const std::span<const RawPairEvent> events = buffer.pairEvents.Get();
+                m_pairMergeBuffer.insert(m_pairMergeBuffer.end(), events.begin(), events.end());
+                buffer.pairEvents.size = 0;
+            }
+
+            if (m_pairMergeBuffer.empty())
+                return;
+
+            const auto byKey = [](const ActivePair &a, const ActivePair &b)
+            { return a.subShapeKey < b.subShapeKey; };
+
+            // Pairs that began are added first, so a pair that begins and ends within the merge still resolves
+            const size_t first = m_pairContacts.size();
+            const size_t numActive = m_activePairs.size();
+            for (const RawPairEvent &event : m_pairMergeBuffer)
+            {
+                if (event.contact.type == ContactEventType::Begin)
+                {
+                    m_activePairs.push_back({event.subShapeKey, event.contact.body1, event.contact.body2});
+                }
+
+                if (event.contact.type == ContactEventType::Begin || event.contact.type == ContactEventType::Persist)
+                {
+                    m_pairContacts.push_back(event.contact);
+                }
+            }
+
+            if (m_activePairs.size() != numActive)
             {
-                return it->second;
+                std::sort(m_activePairs.begin(), m_activePairs.end(), byKey);
+                m_activePairs.erase(std::unique(m_activePairs.begin(), m_activePairs.end(), [](const ActivePair &a, const ActivePair &b)
+                                                { return a.subShapeKey == b.subShapeKey; }),
+                                    m_activePairs.end());
             }
-            else
+
+            bool ended = false;
+            for (const RawPairEvent &event : m_pairMergeBuffer)
+            {
+                if (event.contact.type != ContactEventType::End)
+                    continue;
+
+                auto it = std::lower_bound(m_activePairs.begin(), m_activePairs.end(), ActivePair{event.subShapeKey, c_invalidBodyID, c_invalidBodyID}, byKey);
+                if (it == m_activePairs.end() || it->subShapeKey != event.subShapeKey || it->body1 == c_invalidBodyID)
+                {
+                    // Began while neither body was listened to
+                    continue;
+                }
+
+                PairContact contact = event.contact;
+                contact.body1 = it->body1;
+                contact.body2 = it->body2;
+                contact.key = GetPairKey(contact.body1, contact.body2);
+                m_pairContacts.push_back(contact);
+
+                // Removed in one go below so the array stays sorted for the remaining lookups
+                it->body1 = c_invalidBodyID;
+                ended = true;
+            }
+
+            if (ended)
             {
-                return empty;
+                std::erase_if(m_activePairs, [](const ActivePair &pair)
+                              { return pair.body1 == c_invalidBodyID; });
             }
+
+            // Deterministic order within the step regardless of which thread reported what
+            std::sort(m_pairContacts.begin() + first, m_pairContacts.end(), [](const PairContact &a, const PairContact &b)
+                      { return a.key != b.key ? a.key < b.key : a.type < b.type; });
+        }
+
+        std::span<const Contact> GetContacts(BodyID bodyId) const
+        {
+            auto [first, last] = std::equal_range(m_contactOwners.begin(), m_contactOwners.end(), bodyId);
+            return std::span<const Contact>(m_contacts.data() + (first - m_contactOwners.begin()), static_cast<size_t>(last - first));
+        }
+
+        uint32_t GetNumManifolds() const { return m_numManifolds; }
+        uint32_t GetNumDropped() const { return m_numDropped; }
+
+        // Registrations and touching pairs, kept in physics snapshots so End events still match after a restore
+        struct State
+        {
+            std::array<uint64_t, c_numListeningWords> listening = {};
+            std::vector<ActivePair> activePairs;
+        };
+
+        void SaveState(State &outState) const
+        {
+            outState.listening = m_listening;
+            outState.activePairs = m_activePairs;
+        }
+
+        void RestoreState(const State &state)
+        {
+            m_listening = state.listening;
+            m_activePairs = state.activePairs;
+            ClearContacts();
+        }
+
+        std::span<const PairContact> GetPairContacts() const
+        {
+            return m_pairContacts;
         }
 
         void ClearContacts()
         {
+            m_contactOwners.clear();
             m_contacts.clear();
+            m_pairContacts.clear();
         }
     };
 
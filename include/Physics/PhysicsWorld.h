@@ -1,21 +1,26 @@
 #pragma once
 
+#include "Core/CmdArgs.h"
 #include "Physics/Types.h"
+#include "Physics/Allocators.h"
 #include "Physics/CollisionShapes.h"
 #include "Physics/Layers.h"
 #include "Physics/Listeners.h"
+#include "Physics/ShapeCache.h"
 
 #include "Jolt/Core/TempAllocator.h"
 #include "Jolt/Core/JobSystemThreadPool.h"
 #include "Jolt/Physics/PhysicsSettings.h"
+#include "Jolt/Physics/Body/BodyCreationSettings.h"
 #include "Jolt/Physics/Character/Character.h"
+#include "Jolt/Physics/Character/CharacterVirtual.h"
 
 #include <vector>
 #include <memory>
-#include <unordered_map>
+#include <ostream>
+#include <span>
 #include <thread>
 
-#define SL_MAX_PHYSICS_BODIES 512
 #define INVALID_BODY_ID -1
 
 namespace mk
@@ -28,11 +33,99 @@ namespace mk
         Enemy = Layers::ENEMY,
         PlayerProjectile = Layers::PLAYER_PROJECTILE,
         EnemyProjectile = Layers::ENEMY_PROJECTILE,
+        Debris = Layers::DEBRIS,
 
         Count = Layers::NUM_LAYERS,
         None,
     };
 
+    // Capacities of the Jolt physics system, read from a config file and command line options
+    struct PhysicsWorldSettings
+    {
+        uint32_t maxBodies = 1024;
+        uint32_t numBodyMutexes = 0;
+        uint32_t maxBodyPairs = 65536;
+        uint32_t maxContactConstraints = 10240;
+        uint32_t tempAllocatorSize = 10 * 1024 * 1024;
+        // Contacts and pair events each thread can report to the contact listener in one step
+        uint32_t contactsPerThread = 4096;
+        // -1 uses one less than the number of hardware threads
+        int32_t numThreads = -1;
+        // Same inputs give the same simulation regardless of thread timing, at the cost of sorting constraints
+        bool deterministic = false;
+
+        // -physicsconfig <file> with one "key value" pair per line, then -maxbodies, -maxbodypairs,
+        // -maxcontacts, -physicstempmb, -contactsperthread, -physicsthreads and -deterministic override the file
+        static PhysicsWorldSettings FromCmdArgs(const CmdArgs &cmdArgs);
+    };
+
+    // High water marks since the last reset, contacts counts the manifolds reported by Jolt in one step,
+    // which is what fills the contact constraint buffer. Jolt does not expose the body pair count, so
+    // running out of pairs or constraints shows up in the overflow counters instead.
+    struct PhysicsStats
+    {
+        uint32_t numBodies = 0;
+        uint32_t peakBodies = 0;
+        uint32_t maxBodies = 0;
+        uint32_t numContacts = 0;
+        uint32_t peakContacts = 0;
+        uint32_t maxContactConstraints = 0;
+        size_t peakTempBytes = 0;
+        size_t tempAllocatorSize = 0;
+        uint32_t bodyPairOverflows = 0;
+        uint32_t contactConstraintOverflows = 0;
+        uint32_t manifoldOverflows = 0;
+        // Contact listener reports that did not fit in a thread buffer
+        uint32_t droppedContacts = 0;
+    };
+
+    inline std::ostream &operator<<(std::ostream &out, const PhysicsStats &stats)
+    {
+        constexpr float c_kiB = 1.0f / 1024.0f;
+        out << "Physics: bodies " << stats.numBodies << " (peak " << stats.peakBodies << "/" << stats.maxBodies << ")"
+            << ", contacts " << stats.numContacts << " (peak " << stats.peakContacts << "/" << stats.maxContactConstraints << ")"
+            << ", temp peak " << stats.peakTempBytes * c_kiB << "/" << stats.tempAllocatorSize * c_kiB << " KiB";
+        if (stats.bodyPairOverflows + stats.contactConstraintOverflows + stats.manifoldOverflows + stats.droppedContacts > 0)
+        {
+            out << ", overflows: body pairs " << stats.bodyPairOverflows
+                << ", contact constraints " << stats.contactConstraintOverflows
+                << ", manifolds " << stats.manifoldOverflows
+                << ", dropped contacts " << stats.droppedContacts;
+        }
+        return out;
+    }
+
+    // One bit per ObjectLayer, used to filter queries
+    using ObjectLayerMask = uint32_t;
+    constexpr ObjectLayerMask c_allObjectLayers = ~ObjectLayerMask(0);
+
+    template <typename... Layers>
+    constexpr ObjectLayerMask GetObjectLayerMask(Layers... layers)
+    {
+        return ((ObjectLayerMask(1) << static_cast<uint32_t>(layers)) | ... | 0);
+    }
+
+    struct RaycastQuery
+    {
+        glm::vec3 from;
+        glm::vec3 direction;
+        float distance;
+    };
+
+    struct SphereQuery
+    {
+        glm::vec3 center;
+        float radius;
+    };
+
+    struct OverlapResult
+    {
+        BodyID body;
+        uint32_t data;
+        ObjectLayer layer;
+        glm::vec3 position;
+    };
+
     enum class CharacterGroundState : uint8_t
     {
         // On ground is 0 so that we can use it as a bool
@@ -43,6 +136,25 @@ namespace mk
         Unknown
     };
 
+    enum class BodyCommandType : uint8_t
+    {
+        SetLinearVelocity,
+        SetAngularVelocity,
+        SetRotation,
+        ApplyImpulse,
+
+        Count,
+        None,
+    };
+
+    // Deferred write to a body, rotations are stored as (x, y, z, w)
+    struct BodyCommand
+    {
+        BodyID body;
+        BodyCommandType type;
+        glm::vec4 value;
+    };
+
     // Info for creating a rigid body, not runtime data
     struct RigidBodySettings
     {
@@ -52,7 +164,7 @@ namespace mk
 
         float mass = 1.0f;
         float friction = 0.5f;
-        bool continuousCollision = false;
+        MotionQuality motionQuality = MotionQuality::Discrete;
         float gravityFactor = 1.0f;
         bool isSensor = false;
 
@@ -61,6 +173,24 @@ namespace mk
         uint32_t data = 0;
     };
 
+    using ProjectilePoolID = uint32_t;
+    constexpr ProjectilePoolID c_invalidProjectilePoolID = -1;
+
+    // Pools with equal settings are shared, so callers can look a pool up every time they need it
+    struct ProjectilePoolSettings
+    {
+        float radius = 10.0f;
+        ObjectLayer layer = ObjectLayer::None;
+        MotionQuality motionQuality = MotionQuality::Auto;
+        bool isSensor = false;
+        uint32_t capacity = 32;
+
+        bool operator==(const ProjectilePoolSettings &other) const
+        {
+            return radius == other.radius && layer == other.layer && motionQuality == other.motionQuality && isSensor == other.isSensor;
+        }
+    };
+
     struct CollisionData
     {
         CollisionShape shape;
@@ -74,7 +204,41 @@ namespace mk
     class PhysicsWorld
     {
     private:
-        BodyID m_nextBodyID = 0;
+        // Everything about a slot that a snapshot keeps, the character is only owned by the live slot
+        struct BodyRecord
+        {
+            JPH::BodyID bodyID;
+            ObjectLayer layer = ObjectLayer::None;
+            BodyType type = BodyType::Rigidbody;
+            uint16_t generation = 0;
+            bool alive = false;
+            ProjectilePoolID pool = c_invalidProjectilePoolID;
+            uint32_t data = 0;
+            MotionQuality motionQuality = MotionQuality::Discrete;
+            // Jolt does not save the gravity factor with the body state, only filled in snapshots
+            float gravityFactor = 1.0f;
+            JPH::ShapeRefC shape;
+            CollisionData collision;
+            // Rigid and pooled bodies, to recreate bodies that were destroyed after a snapshot was taken
+            std::shared_ptr<const JPH::BodyCreationSettings> settings;
+        };
+
+        struct BodySlot : BodyRecord
+        {
+            std::unique_ptr<JPH::Character> character;
+            // Index into m_characters, m_virtualCharacters or m_raycastProjectiles, depending on the body type
+            uint32_t denseIndex = 0;
+        };
+
+        BodySlot *GetSlot(BodyID id)
+        {
+            const uint32_t index = GetBodyIndex(id);
+            if (index >= m_slots.size() || !m_slots[index].alive || m_slots[index].generation != GetBodyGeneration(id))
+                return nullptr;
+            return &m_slots[index];
+        }
+
+        const BodySlot *GetSlot(BodyID id) const { return const_cast<PhysicsWorld *>(this)->GetSlot(id); }
 
         std::unique_ptr<JPH::PhysicsSystem> m_physicsSystem;
 
@@ -84,26 +248,153 @@ namespace mk
         BodyActivationListener m_bodyActivationListener;
         ContactListener m_contactListener;
 
-        static std::unique_ptr<JPH::TempAllocatorImpl> s_tempAllocator;
+        static std::unique_ptr<TrackingTempAllocator> s_tempAllocator;
         static std::unique_ptr<JPH::JobSystemThreadPool> s_jobSystem;
 
-        std::unordered_map<uint32_t, JPH::BodyID> m_bodyIDs;
-        std::unordered_map<uint32_t, std::unique_ptr<JPH::Character>> m_characters;
-        std::unordered_map<uint32_t, CollisionData> m_collisions;
+        std::vector<BodySlot> m_slots;
+        std::vector<uint32_t> m_freeSlots;
+
+        // Characters are kept densely so they can be updated in batches on the job system
+        struct VirtualCharacter
+        {
+            JPH::Ref<JPH::CharacterVirtual> character;
+            uint32_t slot;
+            float gravityFactor;
+        };
+
+        std::vector<uint32_t> m_characters;
+        std::vector<VirtualCharacter> m_virtualCharacters;
+
+        // One array per field so the integration only touches what it needs, ids[i] owns the other entries at i
+        struct RaycastProjectiles
+        {
+            std::vector<BodyID> ids;
+            std::vector<glm::vec3> positions;
+            std::vector<glm::vec3> velocities;
+            std::vector<glm::quat> rotations;
+            std::vector<float> gravityFactors;
+        };
+
+        RaycastProjectiles m_raycastProjectiles;
+        // The temp allocator is not thread safe, every character update job gets its own
+        std::vector<std::unique_ptr<JPH::TempAllocatorImpl>> m_characterAllocators;
+
+        std::vector<BodyCommand> m_commands;
+        // Scratch for GetRigidBodyStates, kept so the per step readback does not allocate. The body state is
+        // copied out under the lock and converted to game units after it is released.
+        std::vector<JPH::BodyID> m_readbackBodyIDs;
+        std::vector<JPH::Vec3> m_readbackPositions;
+        std::vector<JPH::Quat> m_readbackRotations;
+        std::vector<JPH::Vec3> m_readbackLinearVelocities;
+        std::vector<JPH::Vec3> m_readbackAngularVelocities;
+        // Index into m_commands per body slot and command type, so each body has at most one command of a type
+        std::vector<uint32_t> m_commandIndices;
+
+        // Bodies stay created while in the pool and are only added to and removed from the physics system
+        struct ProjectilePool
+        {
+            ProjectilePoolSettings settings;
+            JPH::ShapeRefC shape;
+            std::vector<uint32_t> freeSlots;
+            std::shared_ptr<const JPH::BodyCreationSettings> bodySettings;
+        };
+
+        std::vector<ProjectilePool> m_projectilePools;
+
+        // Debris is put to sleep by PhysicsWorld once it has been slow for a short while, much sooner than
+        // Jolt's global sleep settings would
+        struct DebrisBody
+        {
+            BodyID id;
+            float restTime;
+        };
+
+        std::vector<DebrisBody> m_debris;
+
+        // Bodies with MotionQuality::Auto, switched between discrete and linear cast before every step
+        struct AutoMotionQualityBody
+        {
+            BodyID id;
+            // Distance per step above which the body is swept, a fraction of the shape's inner radius
+            float castDistance;
+            bool linearCast;
+        };
+
+        std::vector<AutoMotionQualityBody> m_autoMotionQuality;
+
+        ShapeCache m_shapeCache;
+
+        PhysicsWorldSettings m_settings;
+        PhysicsStats m_stats;
+
+        uint32_t AllocateSlot();
+        void ReleaseSlot(uint32_t index);
+        void CreatePooledBody(ProjectilePoolID poolID);
+
+        void QueueCommand(BodyID id, BodyCommandType type, const glm::vec4 &value);
+        void ClearCommands();
+        void FlushCommands();
+        void UpdateDebris(float dt);
+        void TrackMotionQuality(BodyID id, const BodySlot &slot);
+        void UpdateMotionQuality(float dt);
+        void UpdateVirtualCharacters(float dt);
+        void PostSimulateCharacters();
+        void RemoveCharacter(BodySlot &slot);
+        void UpdateRaycastProjectiles(float dt);
+        void RemoveRaycastProjectile(BodySlot &slot);
+        RigidBodyState GetRaycastProjectileState(const BodySlot &slot) const;
+
+        JPH::CharacterVirtual *GetVirtualCharacter(const BodySlot &slot) const
+        {
+            return slot.type == BodyType::VirtualCharacter ? m_virtualCharacters[slot.denseIndex].character.GetPtr() : nullptr;
+        }
+        uint32_t OverlapShape(const JPH::Shape *shape, const JPH::RMat44 &transform, std::span<OverlapResult> outResults, ObjectLayerMask layers) const;
 
     public:
+        // Binary copy of the bodies, velocities, contacts, characters and BodyID mappings of the world.
+        // Restoring rewinds BodyIDs as well, so handles created after the snapshot have to be dropped
+        // together with the rest of the rolled back game state.
+        class Snapshot
+        {
+        private:
+            friend class PhysicsWorld;
+
+            const PhysicsWorld *m_world = nullptr;
+            std::vector<BodyRecord> m_slots;
+            std::vector<uint8_t> m_state;
+            ContactListener::State m_contactState;
+            RaycastProjectiles m_raycastProjectiles;
+
+        public:
+            bool IsEmpty() const { return m_slots.empty(); }
+            size_t GetSize() const
+            {
+                const size_t projectileSize = sizeof(BodyID) + 2 * sizeof(glm::vec3) + sizeof(glm::quat) + sizeof(float);
+                return m_state.size() + m_slots.size() * sizeof(BodyRecord) + sizeof(ContactListener::State) + m_contactState.activePairs.size() * sizeof(m_contactState.activePairs[0]) +
+                       m_raycastProjectiles.ids.size() * projectileSize;
+            }
+        };
+
         PhysicsWorld() = default;
         ~PhysicsWorld() = default;
 
-        void Initialize();
+        void Initialize(const PhysicsWorldSettings &settings = {});
         void Shutdown();
 
         void StepSimulation(float dt, uint32_t numSubSteps = 1);
         RigidBodyState GetRigidBodyState(BodyID id);
+        // Reads the state of many bodies under a single body lock, outStates must be at least as large as ids
+        void GetRigidBodyStates(std::span<const BodyID> ids, std::span<RigidBodyState> outStates);
         glm::vec3 GetPosition(BodyID id);
         glm::vec3 GetLinearVelocity(BodyID id);
-        OptionalCollisionData GetCollisionData(BodyID id) const { return m_collisions.find(id) != m_collisions.end() ? std::make_optional(m_collisions.at(id)) : std::nullopt; }
-        bool IsBodyValid(BodyID id) const { return m_bodyIDs.find(id) != m_bodyIDs.end(); }
+        OptionalCollisionData GetCollisionData(BodyID id) const
+        {
+            const BodySlot *slot = GetSlot(id);
+            return slot != nullptr ? std::make_optional(slot->collision) : std::nullopt;
+        }
+        bool IsBodyValid(BodyID id) const { return GetSlot(id) != nullptr; }
+        // Sleeping bodies have not moved since the step they went to sleep in
+        bool IsBodyActive(BodyID id) const;
         ObjectLayer GetObjectLayer(BodyID id) const;
 
         BodyID CreateRigidBody(const RigidBodySettings &info, BodyType type);
@@ -111,23 +402,77 @@ namespace mk
         void RemoveRigidBody(BodyID id);
         void RemoveAllRigidBodies();
 
+        // Reuses the buffers of outSnapshot, so saving into the same snapshot every frame does not allocate
+        void SaveSnapshot(Snapshot &outSnapshot) const;
+        // Destroys bodies created since the snapshot and recreates removed ones under their old BodyID before
+        // restoring the Jolt state. Fails without changing anything if the snapshot is from another world, or a
+        // character or a body without creation settings was removed since.
+        bool RestoreSnapshot(const Snapshot &snapshot);
+
+        ShapeCache &GetShapeCache() { return m_shapeCache; }
+
+        ProjectilePoolID GetProjectilePool(const ProjectilePoolSettings &settings);
+        BodyID AcquireProjectileBody(ProjectilePoolID poolID, const glm::vec3 &position, const glm::quat &rotation, const glm::vec3 &velocity, float gravityFactor = 0.0f, uint32_t data = 0);
+        void ReleaseProjectileBody(BodyID id);
+        uint32_t GetNumFreeProjectileBodies(ProjectilePoolID poolID) const { return static_cast<uint32_t>(m_projectilePools[poolID].freeSlots.size()); }
+
+        // Projectile without a Jolt body, far cheaper than a pooled one so many more can be in flight. It is swept
+        // with a ray, ignoring its size, and stops at the first body its layer collides with. The hit is reported
+        // through GetContacts like a body contact. Removed with RemoveRigidBody.
+        BodyID CreateRaycastProjectile(ObjectLayer layer, const glm::vec3 &position, const glm::quat &rotation, const glm::vec3 &velocity, float gravityFactor = 0.0f, uint32_t data = 0);
+        uint32_t GetNumRaycastProjectiles() const { return static_cast<uint32_t>(m_raycastProjectiles.ids.size()); }
+
         void SetPosition(BodyID id, glm::vec3 position);
         void SetRotation(BodyID id, glm::quat rotation);
         void SetLinearVelocity(BodyID id, glm::vec3 velocity);
         void SetAngularVelocity(BodyID id, glm::vec3 velocity);
         void ApplyImpulse(BodyID id, const glm::vec3 &impulse);
         void SetGravityFactor(BodyID id, float factor);
+        // Moves a rigid body to the debris layer, where it only collides with the level and sleeps aggressively
+        void SetDebris(BodyID id);
+
+        // Queued writes, applied in one batch at the start of the next StepSimulation. Writes queued again before
+        // then replace the earlier value, impulses add up.
+        void QueueLinearVelocity(BodyID id, const glm::vec3 &velocity) { QueueCommand(id, BodyCommandType::SetLinearVelocity, glm::vec4(velocity, 0.0f)); }
+        void QueueAngularVelocity(BodyID id, const glm::vec3 &velocity) { QueueCommand(id, BodyCommandType::SetAngularVelocity, glm::vec4(velocity, 0.0f)); }
+        void QueueRotation(BodyID id, const glm::quat &rotation) { QueueCommand(id, BodyCommandType::SetRotation, glm::vec4(rotation.x, rotation.y, rotation.z, rotation.w)); }
+        void QueueImpulse(BodyID id, const glm::vec3 &impulse) { QueueCommand(id, BodyCommandType::ApplyImpulse, glm::vec4(impulse, 0.0f)); }
+        size_t GetNumQueuedCommands() const { return m_commands.size(); }
 
         CharacterGroundState GetCharacterGroundState(BodyID id);
         void SetCharacterRotation(BodyID id, glm::quat rotation);
 
         void RegisterContactListener(BodyID id);
         void UnregisterContactListener(BodyID id);
-        const std::vector<Contact> &GetContacts(BodyID id) const;
-        const std::vector<PairContact> &GetPairContacts() const;
+        std::span<const Contact> GetContacts(BodyID id) const;
+        // Begin, persist and end events of listened bodies since the last ResetContacts
+        std::span<const PairContact> GetPairContacts() const;
         void ResetContacts();
 
+        size_t GetTempAllocatorSize() const { return s_tempAllocator->GetSize(); }
+        size_t GetTempAllocatorPeakUsage() const { return s_tempAllocator->GetPeakUsage(); }
+        void ResetTempAllocatorPeakUsage() { s_tempAllocator->ResetPeakUsage(); }
+
+        const PhysicsWorldSettings &GetSettings() const { return m_settings; }
+        PhysicsStats GetStats() const;
+        // Hash of the slots and body states of all live bodies, compare between runs to find where they diverge
+        uint64_t ComputeChecksum() const;
+        // Resets the peaks and overflow counters, including the temp allocator peak
+        void ResetStats();
+
         std::vector<RaycastResult> Raycast(const glm::vec3 &from, const glm::vec3 &direction, float distance, RaycastType type = RaycastType::Closest) const;
         std::vector<BodyID> CastSphere(const glm::vec3 &center, float radius) const;
+
+        // Narrow phase overlap, one result per body with its center of mass position and layer.
+        // Returns the number of bodies found. Only the first outResults.size() are written, so a larger count means
+        // the query has to be repeated with more room to see all of them.
+        uint32_t OverlapSphere(const glm::vec3 &center, float radius, std::span<OverlapResult> outResults, ObjectLayerMask layers = c_allObjectLayers) const;
+        uint32_t OverlapShape(const CollisionShape &shape, const glm::vec3 &position, const glm::quat &rotation, std::span<OverlapResult> outResults, ObjectLayerMask layers = c_allObjectLayers) const;
+
+        // Closest hit per ray, misses get c_invalidBodyID as hitBody. Large batches are split over the job system.
+        void RaycastBatch(std::span<const RaycastQuery> queries, std::span<RaycastResult> outResults, ObjectLayerMask layers = c_allObjectLayers) const;
+        // Bodies whose bounds overlap each sphere, query i writes up to maxHitsPerQuery bodies starting at
+        // outBodies[i * maxHitsPerQuery] and its hit count to outCounts[i]
+        void CastSphereBatch(std::span<const SphereQuery> queries, std::span<BodyID> outBodies, std::span<uint32_t> outCounts, uint32_t maxHitsPerQuery, ObjectLayerMask layers = c_allObjectLayers) const;
     };
 }
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Jolt/Jolt.h"
+#include "Jolt/Physics/Collision/Shape/Shape.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mk
+{
+    enum class BakedShapeType : uint32_t
+    {
+        // Convex hull of all vertices, for dynamic bodies
+        ConvexHull,
+        // Triangle mesh, only valid for static bodies
+        Mesh,
+
+        Count,
+        None,
+    };
+
+    // Shapes are baked offline from the untransformed model vertices and stored in a sidecar next to the model,
+    // so neither spawning nor loading has to build a hull. The file is a small header followed by Jolt's binary
+    // shape serialization.
+    namespace ShapeBaking
+    {
+        constexpr uint32_t c_magic = 0x48534b4d; // "MKSH"
+        constexpr uint32_t c_version = 1;
+
+        // models/drone/drone.dat -> models/drone/drone.dat.shape
+        inline std::string GetSidecarPath(const std::string &modelPath)
+        {
+            return modelPath + ".shape";
+        }
+
+        bool BakeShape(BakedShapeType type, const std::vector<glm::vec3> &vertices, const std::vector<uint32_t> &indices, const std::string &path);
+
+        // Memory maps the sidecar and restores the shape from it, returns nullptr if there is no valid sidecar
+        JPH::ShapeRefC LoadBakedShape(const std::string &path);
+
+        // Applies a model transform to a baked shape with decorated shapes, only uniform scale is supported
+        JPH::ShapeRefC TransformShape(const JPH::ShapeRefC &shape, const glm::mat4 &transform);
+    }
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "Physics/CollisionShapes.h"
+#include "Physics/ShapeBaking.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+
+namespace mk
+{
+    // Identifies a shape built from some source data, e.g. a mesh handle, with a transform baked in
+    struct ShapeCacheKey
+    {
+        uint32_t source = 0;
+        CollisionShapeType type = CollisionShapeType::None;
+        glm::mat4 transform = glm::mat4(1.0f);
+
+        bool operator==(const ShapeCacheKey &other) const
+        {
+            return source == other.source && type == other.type && transform == other.transform;
+        }
+    };
+
+    struct ShapeCacheKeyHash
+    {
+        size_t operator()(const ShapeCacheKey &key) const
+        {
+            // FNV-1a over the key, same as GetHandle
+            uint32_t hash = 0x811c9dc5;
+            const auto combine = [&](const void *data, size_t size)
+            {
+                const uint8_t *bytes = static_cast<const uint8_t *>(data);
+                for (size_t i = 0; i < size; i++)
+                {
+                    hash ^= bytes[i];
+                    hash *= 0x1000193;
+                }
+            };
+
+            combine(&key.source, sizeof(key.source));
+            combine(&key.type, sizeof(key.type));
+            combine(&key.transform, sizeof(key.transform));
+            return hash;
+        }
+    };
+
+    // Collision shapes are cheap to copy once created (mesh data is shared), so bodies created from the
+    // same key share one shape and one Jolt shape instead of rebuilding it per body.
+    class ShapeCache
+    {
+    private:
+        std::unordered_map<ShapeCacheKey, CollisionShape, ShapeCacheKeyHash> m_shapes;
+        // Untransformed shapes loaded from sidecars, keyed by source
+        std::unordered_map<uint32_t, JPH::ShapeRefC> m_bakedShapes;
+
+    public:
+        ShapeCache() = default;
+        ~ShapeCache() = default;
+
+        // create() is only called on a miss and must return a shape of the keyed type
+        template <typename F>
+        const CollisionShape &GetOrCreate(const ShapeCacheKey &key, F &&create)
+        {
+            auto it = m_shapes.find(key);
+            if (it == m_shapes.end())
+            {
+                it = m_shapes.emplace(key, CollisionShape(create())).first;
+                assert(GetCollisionShapeType(it->second) == key.type && "Shape type does not match key");
+            }
+
+            return it->second;
+        }
+
+        bool LoadBakedShape(uint32_t source, const std::string &path)
+        {
+            JPH::ShapeRefC shape = ShapeBaking::LoadBakedShape(path);
+            if (shape == nullptr)
+                return false;
+
+            m_bakedShapes[source] = shape;
+            return true;
+        }
+
+        // Gives the mesh shape the baked shape for source, if one was loaded, so no hull is built for it
+        bool ApplyBakedShape(uint32_t source, const glm::mat4 &transform, MeshShape &shape) const
+        {
+            auto it = m_bakedShapes.find(source);
+            if (it == m_bakedShapes.end())
+                return false;
+
+            shape.SetShape(ShapeBaking::TransformShape(it->second, transform));
+            return true;
+        }
+
+        size_t GetSize() const { return m_shapes.size(); }
+        void Clear()
+        {
+            m_shapes.clear();
+            m_bakedShapes.clear();
+        }
+    };
+}
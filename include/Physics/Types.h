@@ -10,10 +10,36 @@ namespace mk
     using BodyID = uint32_t;
     constexpr BodyID c_invalidBodyID = -1;
 
+    // A BodyID is a slot index in the low bits and the slot generation in the high bits,
+    // so handles to removed bodies are detected instead of aliasing a reused slot.
+    constexpr uint32_t c_bodyIndexBits = 16;
+    constexpr uint32_t c_bodyIndexMask = (1u << c_bodyIndexBits) - 1;
+    constexpr uint32_t c_maxBodyGeneration = (1u << (32 - c_bodyIndexBits)) - 1;
+
+    inline uint32_t GetBodyIndex(BodyID id) { return id & c_bodyIndexMask; }
+    inline uint32_t GetBodyGeneration(BodyID id) { return id >> c_bodyIndexBits; }
+    inline BodyID MakeBodyID(uint32_t index, uint32_t generation) { return (generation << c_bodyIndexBits) | index; }
+
     enum class BodyType : uint8_t
     {
         Rigidbody = 0,
         Character = 1,
+        // Kinematic CharacterVirtual with an inner body, so other bodies and queries still see it
+        VirtualCharacter = 2,
+        // No Jolt body, advanced analytically and swept with a ray cast every step
+        RaycastProjectile = 3,
+    };
+
+    enum class MotionQuality : uint8_t
+    {
+        Discrete,
+        // Swept every step, for small bodies that are always fast
+        LinearCast,
+        // Swept only on the steps where the body moves further than a fraction of its size
+        Auto,
+
+        Count,
+        None,
     };
 
     struct RaycastResult
@@ -0,0 +1,16 @@
+#pragma once
+
+#ifdef MK_HEADLESS
+#include "Headless/NullRenderer.h"
+#else
+#include "Vultron/SceneRenderer.h"
+#endif
+
+namespace mk
+{
+#ifdef MK_HEADLESS
+    using Renderer = NullRenderer;
+#else
+    using Renderer = Vultron::SceneRenderer;
+#endif
+}
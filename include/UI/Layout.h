@@ -1,7 +1,7 @@
 #pragma once
 
 #include "UI/Types.h"
-#include "Vultron/SceneRenderer.h"
+#include "Renderer.h"
 
 #include <glm/glm.hpp>
 
@@ -35,7 +35,7 @@ namespace mk::Layout
     glm::vec2 GetSize(const LayoutValue &size, const glm::vec2 &baseSize);
     glm::vec2 GetPosition(const LayoutValue &position, const glm::vec2 &basePosition, const glm::vec2 &baseSize);
 
-    void Render(const SceneRenderer &renderer, UIContext &context, Container &layout, const glm::vec2 &basePosition, const glm::vec2 &baseSize, const std::string &idString, const glm::vec2 &aspectRatio, const std::optional<Container> &parent = std::nullopt, float scale = 1.0f, float zIndex = 0.0f, float opacity = 1.0f);
-    void Render(const SceneRenderer &renderer, UIContext &context, Text &text, const glm::vec2 &basePosition, const glm::vec2 &baseSize, const std::string &idString, const glm::vec2 &aspectRatio, const std::optional<Container> &parent = std::nullopt, float scale = 1.0f, float zIndex = 0.0f, float opacity = 1.0f);
-    void Render(const SceneRenderer &renderer, UIContext &context, Image &text, const glm::vec2 &basePosition, const glm::vec2 &baseSize, const std::string &idString, const glm::vec2 &aspectRatio, const std::optional<Container> &parent = std::nullopt, float scale = 1.0f, float zIndex = 0.0f, float opacity = 1.0f);
+    void Render(const Renderer &renderer, UIContext &context, Container &layout, const glm::vec2 &basePosition, const glm::vec2 &baseSize, const std::string &idString, const glm::vec2 &aspectRatio, const std::optional<Container> &parent = std::nullopt, float scale = 1.0f, float zIndex = 0.0f, float opacity = 1.0f);
+    void Render(const Renderer &renderer, UIContext &context, Text &text, const glm::vec2 &basePosition, const glm::vec2 &baseSize, const std::string &idString, const glm::vec2 &aspectRatio, const std::optional<Container> &parent = std::nullopt, float scale = 1.0f, float zIndex = 0.0f, float opacity = 1.0f);
+    void Render(const Renderer &renderer, UIContext &context, Image &text, const glm::vec2 &basePosition, const glm::vec2 &baseSize, const std::string &idString, const glm::vec2 &aspectRatio, const std::optional<Container> &parent = std::nullopt, float scale = 1.0f, float zIndex = 0.0f, float opacity = 1.0f);
 }
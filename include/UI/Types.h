@@ -2,7 +2,7 @@
 
 #include "Vultron/Types.h"
 #include "UI/Constants.h"
-#include "Input/InputDevice.h"
+#include "Input/InputState.h"
 #include "Audio/AudioSystem.h"
 
 #include <string>
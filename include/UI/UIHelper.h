@@ -2,8 +2,8 @@
 
 #include "UI/Types.h"
 
-#include "Input/InputDevice.h"
-#include "Vultron/SceneRenderer.h"
+#include "Input/InputState.h"
+#include "Renderer.h"
 
 #include <glm/glm.hpp>
 #include <string>
@@ -23,9 +23,9 @@ namespace mk::UIHelper
     glm::vec2 GetScreenPositionFromWorldPosition(const glm::vec3 &worldPosition, const glm::mat4 &projectionMatrix, const glm::mat4 &viewMatrix);
     glm::vec3 GetWorldPositionFromScreenPosition(const glm::vec2 &screenPosition, const glm::mat4 &projectionMatrix, const glm::mat4 &viewMatrix, float yPlane);
     std::string GetTimeString(float time);
-    glm::vec4 RenderText(SceneRenderer &renderer, RenderHandle fontAtlas, RenderHandle fontMaterial, const std::string &text, const glm::vec2 &position, float size, const glm::vec4 &color, TextAlignment alignment = TextAlignment::Center, bool centerVertically = true, uint32_t maxLineLength = 0, float lineSpacing = 0.0f);
-    glm::vec4 RenderText(const SceneRenderer &renderer, UIContext &context, const std::string &text, const glm::vec2 &position, float size, const glm::vec4 &color, TextAlignment alignment = TextAlignment::Center, bool centerVertically = true, uint32_t maxLineLength = 0, float lineSpacing = 0.0f);
-    void RenderProgressBar(SceneRenderer &renderer, RenderHandle material, const glm::vec2 &position, const glm::vec2 &size, const glm::vec2 &texCoord, const glm::vec2 &texSize, float percent, const glm::vec4 &fillColor, const glm::vec4 &backgroundColor, float aspectRatio);
+    glm::vec4 RenderText(Renderer &renderer, RenderHandle fontAtlas, RenderHandle fontMaterial, const std::string &text, const glm::vec2 &position, float size, const glm::vec4 &color, TextAlignment alignment = TextAlignment::Center, bool centerVertically = true, uint32_t maxLineLength = 0, float lineSpacing = 0.0f);
+    glm::vec4 RenderText(const Renderer &renderer, UIContext &context, const std::string &text, const glm::vec2 &position, float size, const glm::vec4 &color, TextAlignment alignment = TextAlignment::Center, bool centerVertically = true, uint32_t maxLineLength = 0, float lineSpacing = 0.0f);
+    void RenderProgressBar(Renderer &renderer, RenderHandle material, const glm::vec2 &position, const glm::vec2 &size, const glm::vec2 &texCoord, const glm::vec2 &texSize, float percent, const glm::vec4 &fillColor, const glm::vec4 &backgroundColor, float aspectRatio);
     bool IsPointInRect(const glm::vec2 &point, const glm::vec2 &rectPosition, const glm::vec2 &rectSize);
     void PlayHoverSound();
     void PlayClickSound();
@@ -1,5 +1,6 @@
 #include "Application.h"
 
+#include "Core/EntityStore.h"
 #include "Core/Logger.h"
 
 #include <glm/glm.hpp>
@@ -9,6 +10,7 @@
 #include <future>
 #include <iostream>
 #include <random>
+#include <string>
 
 using namespace Vultron;
 
@@ -18,8 +20,7 @@ namespace mk
 
     bool Application::Initialize()
     {
-        m_random.gen = std::mt19937(m_random.rd());
-        m_random.dis = std::uniform_real_distribution<float>(0.0f, 1.0f);
+        InitializeRandom();
 
         Window::WindowCreateInfo windowCreateInfo = {
             .title = "Monke",
@@ -68,7 +69,7 @@ namespace mk
             return false;
         }
 
-        m_physicsWorld.Initialize();
+        m_physicsWorld.Initialize(PhysicsWorldSettings::FromCmdArgs(m_cmdArgs));
 
         m_game.OnInitialize();
 
@@ -83,6 +84,18 @@ namespace mk
 
         m_eventBus.Update();
         m_audioSystem.Update();
+
+        SampleMemoryInfo();
+    }
+
+    void Application::SampleMemoryInfo()
+    {
+        // Game side entries are filled in by the game itself during update and render
+        MemoryInfo &memory = m_debugInfo.memory;
+        memory.entityStoreBytes = MemoryAllocator::get_total_allocated_memory();
+        memory.physicsTempPeakBytes = m_physicsWorld.GetTempAllocatorPeakUsage();
+        memory.physicsTempCapacity = m_physicsWorld.GetTempAllocatorSize();
+        memory.numAudioEvents = static_cast<uint32_t>(m_audioSystem.GetNumEvents());
     }
 
     void Application::FixedUpdate(float dt, uint32_t numSubSteps)
@@ -117,10 +130,10 @@ namespace mk
         debugSamples.reserve(1000);
         std::chrono::high_resolution_clock debugClock;
         auto debugInfoLastUpdate = debugClock.now();
+        auto memoryLogLastUpdate = debugClock.now();
 
         std::chrono::high_resolution_clock clock;
         auto lastTime = clock.now();
-        float timeSincePhysics = 0.0f;
 
         auto currentTime = clock.now();
         while (!m_window.ShouldShutdown())
@@ -156,17 +169,16 @@ namespace mk
 
             auto physicsStart = debugClock.now();
 
-            m_physicsWorld.ResetContacts();
-            timeSincePhysics += deltaTime;
-            if (timeSincePhysics >= c_fixedUpdateInterval)
-            {
-                const uint32_t numSubSteps = static_cast<uint32_t>(timeSincePhysics / c_fixedUpdateInterval);
-                const float physicsDeltaTime = numSubSteps * c_fixedUpdateInterval;
-                timeSincePhysics -= physicsDeltaTime;
-                FixedUpdate(physicsDeltaTime * m_timeScale, glm::min(numSubSteps, c_maxSubSteps));
-            }
+            // Fixed systems run once per step so that the simulation does not depend on the frame rate
+            m_fixedStepScheduler.Advance(
+                deltaTime * m_timeScale,
+                [&](float stepDeltaTime, uint32_t numSteps)
+                {
+                    m_physicsWorld.ResetContacts();
+                    FixedUpdate(stepDeltaTime, numSteps);
+                });
 
-            m_timeSincePhysics = timeSincePhysics;
+            m_timeSincePhysics = m_fixedStepScheduler.GetAccumulator();
 
             auto physicsEnd = debugClock.now();
 
@@ -195,6 +207,8 @@ namespace mk
                 .updateTime = std::chrono::duration<float, std::chrono::milliseconds::period>(updateEnd - updateStart).count(),
                 .renderTime = std::chrono::duration<float, std::chrono::milliseconds::period>(renderEnd - renderStart).count(),
                 .totalTime = std::chrono::duration<float, std::chrono::milliseconds::period>(end - start).count(),
+                .fixedSteps = m_fixedStepScheduler.GetStats().frameSteps,
+                .droppedTime = m_fixedStepScheduler.GetStats().droppedTime,
             });
 
             if (std::chrono::duration<float>(debugClock.now() - debugInfoLastUpdate).count() > c_debugInfoUpdateInterval)
@@ -203,22 +217,41 @@ namespace mk
                 float updateTime = 0.0f;
                 float renderTime = 0.0f;
                 float totalTime = 0.0f;
+                uint32_t fixedSteps = 0;
+                float droppedTime = 0.0f;
                 for (const auto &sample : debugSamples)
                 {
                     physicsTime += sample.physicsTime;
                     updateTime += sample.updateTime;
                     renderTime += sample.renderTime;
                     totalTime += sample.totalTime;
+                    fixedSteps += sample.fixedSteps;
+                    droppedTime += sample.droppedTime;
                 }
 
                 m_debugInfo.physicsTime = physicsTime / debugSamples.size();
                 m_debugInfo.updateTime = updateTime / debugSamples.size();
                 m_debugInfo.renderTime = renderTime / debugSamples.size();
                 m_debugInfo.totalTime = totalTime / debugSamples.size();
+                m_debugInfo.fixedSteps = static_cast<float>(fixedSteps) / debugSamples.size();
+                m_debugInfo.droppedTime = droppedTime;
+
+                if (droppedTime > 0.0f)
+                {
+                    std::cerr << "Fixed update fell behind, dropped " << droppedTime * 1000.0f << " ms of simulation time" << std::endl;
+                }
 
                 debugSamples.clear();
                 debugInfoLastUpdate = debugClock.now();
             }
+
+            if (std::chrono::duration<float>(debugClock.now() - memoryLogLastUpdate).count() > c_memoryLogInterval)
+            {
+                std::cout << m_debugInfo.memory << std::endl;
+                std::cout << m_physicsWorld.GetStats() << std::endl;
+                m_physicsWorld.ResetStats();
+                memoryLogLastUpdate = debugClock.now();
+            }
         }
 
         Shutdown();
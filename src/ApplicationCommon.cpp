@@ -0,0 +1,25 @@
+#include "Application.h"
+
+#include "Game/Helpers/ParticleHelper.h"
+
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace mk
+{
+    // Application members shared by the windowed and the headless build
+
+    void Application::InitializeRandom()
+    {
+        // A missing or invalid seed starts a fresh random session
+        m_random.seed = m_cmdArgs.GetOptionNumber<uint32_t>("-seed").value_or(std::random_device()());
+
+        m_random.gen = std::mt19937(m_random.seed);
+        m_random.dis = std::uniform_real_distribution<float>(0.0f, 1.0f);
+
+        ParticleHelper::Seed(GetRandomSeed());
+
+        std::cout << "Session seed: " << m_random.seed << std::endl;
+    }
+}
@@ -1,5 +1,6 @@
 #include "Audio/AudioSystem.h"
 
+#include "fmod_studio.hpp"
 #include <glm/gtc/quaternion.hpp>
 
 #include <iostream>
@@ -1,16 +1,16 @@
 #include "Game/Game.h"
 
 #include "Application.h"
-#include "Vultron/SceneRenderer.h"
+#include "Renderer.h"
 #include "Audio/AudioSystem.h"
-#include "Input/InputDevice.h"
+#include "Input/InputState.h"
 #include "Physics/PhysicsWorld.h"
 
 namespace mk
 {
     void Game::OnInitialize()
     {
-        auto &renderer = const_cast<SceneRenderer &>(Application::GetRenderer());
+        auto &renderer = const_cast<Renderer &>(Application::GetRenderer());
         renderer.CreateMaterial<FontSpriteMaterial>(
             "FontMaterial",
             {
@@ -45,7 +45,7 @@ namespace mk
         }
     }
 
-    void Game::OnRender(SceneRenderer &renderer)
+    void Game::OnRender(Renderer &renderer)
     {
         m_stateMachine.Visit([&](auto &state)
                              { GameStateImpl::OnRender(renderer, state); });
@@ -59,9 +59,11 @@ namespace mk
 
     void Game::GoToMainMenu()
     {
+        m_queuedState = GameStates::MainMenuState{};
     }
 
     void Game::RestartGame()
     {
+        m_queuedState = GameStates::PlayingState{};
     }
 }
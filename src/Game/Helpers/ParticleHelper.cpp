@@ -4,10 +4,15 @@
 
 namespace mk::ParticleHelper
 {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
+    static std::mt19937 gen;
     static std::uniform_real_distribution<float> dis(-1.0f, 1.0f);
 
+    void Seed(uint32_t seed)
+    {
+        gen.seed(seed);
+        dis.reset();
+    }
+
     constexpr glm::vec3 c_fireColor = glm::vec3(255.0f, 150.0f, 30.0f) / 255.0f * 10.0f;
     constexpr glm::vec3 c_iceColor = glm::vec3(0.0f, 0.5f, 1.0f) * 2.0f;
     constexpr glm::vec3 c_plasmaColor = glm::vec3(1.0f, 0.0f, 1.0f) * 2.0f;
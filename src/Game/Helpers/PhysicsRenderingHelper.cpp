@@ -1,196 +1,197 @@
 #include "Game/Helpers/PhysicsRenderingHelper.h"
 
+#include "glm/gtc/constants.hpp"
 #include "glm/gtc/quaternion.hpp"
 #include "glm/gtx/quaternion.hpp"
 
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+
 namespace mk::PhysicsRenderingHelper
 {
     constexpr uint32_t c_numSegments = 16;
 
-    void RenderShape(SceneRenderer &renderer, const glm::vec3 &position, const glm::quat &rotation, const BoxShape &boxShape, const glm::vec4 &color)
+    // Shape outline in local space, built once per shape and only transformed per body. Vertices are scaled per
+    // body and then moved along the local Y axis by their offset times the half height, which lets one
+    // wireframe serve every capsule.
+    struct Wireframe
+    {
+        std::vector<glm::vec3> vertices;
+        std::vector<float> offsets;
+        // Pairs of vertex indices
+        std::vector<uint32_t> edges;
+    };
+
+    struct MeshWireframe
+    {
+        std::weak_ptr<const void> data;
+        Wireframe wireframe;
+    };
+
+    // numSegments steps of a circle split into totalSegments, in the plane of axisA and axisB
+    static void AddArc(Wireframe &wireframe, uint32_t totalSegments, const glm::vec3 &axisA, const glm::vec3 &axisB, float startAngle, uint32_t numSegments, float offset)
     {
-        const glm::vec3 halfExtents = boxShape.GetHalfExtents();
-        // Define the eight vertices of the box
-        glm::vec3 vertices[8];
-        vertices[0] = position + glm::rotate(rotation, glm::vec3(-halfExtents.x, -halfExtents.y, -halfExtents.z));
-        vertices[1] = position + glm::rotate(rotation, glm::vec3(-halfExtents.x, -halfExtents.y, halfExtents.z));
-        vertices[2] = position + glm::rotate(rotation, glm::vec3(-halfExtents.x, halfExtents.y, -halfExtents.z));
-        vertices[3] = position + glm::rotate(rotation, glm::vec3(-halfExtents.x, halfExtents.y, halfExtents.z));
-        vertices[4] = position + glm::rotate(rotation, glm::vec3(halfExtents.x, -halfExtents.y, -halfExtents.z));
-        vertices[5] = position + glm::rotate(rotation, glm::vec3(halfExtents.x, -halfExtents.y, halfExtents.z));
-        vertices[6] = position + glm::rotate(rotation, glm::vec3(halfExtents.x, halfExtents.y, -halfExtents.z));
-        vertices[7] = position + glm::rotate(rotation, glm::vec3(halfExtents.x, halfExtents.y, halfExtents.z));
-
-        // Define the indices for the edges of the box
-        constexpr int edgeIndices[12][2] = {
-            {0, 1}, {1, 3}, {3, 2}, {2, 0}, {4, 5}, {5, 7}, {7, 6}, {6, 4}, {0, 4}, {1, 5}, {2, 6}, {3, 7}};
-
-        for (uint32_t i = 0; i < 12; i++)
+        const float angleIncrement = glm::two_pi<float>() / float(totalSegments);
+        const uint32_t first = static_cast<uint32_t>(wireframe.vertices.size());
+        for (uint32_t i = 0; i <= numSegments; i++)
         {
-            uint32_t startIndex = edgeIndices[i][0];
-            uint32_t endIndex = edgeIndices[i][1];
-            glm::vec3 start = vertices[startIndex];
-            glm::vec3 end = vertices[endIndex];
-            renderer.SubmitRenderJob({start, end, color});
+            const float angle = startAngle + float(i) * angleIncrement;
+            wireframe.vertices.push_back(axisA * glm::cos(angle) + axisB * glm::sin(angle));
+            wireframe.offsets.push_back(offset);
+            if (i > 0)
+            {
+                wireframe.edges.push_back(first + i - 1);
+                wireframe.edges.push_back(first + i);
+            }
         }
     }
 
-    void RenderShape(SceneRenderer &renderer, const glm::vec3 &position, const glm::quat &rotation, const SphereShape &sphereShape, const glm::vec4 &color)
+    // Unit radius, a ring around every axis
+    static const Wireframe &GetSphereWireframe(uint32_t numSegments)
     {
-        const float angleIncrement = glm::radians(360.0f / c_numSegments);
-        float radius = sphereShape.GetRadius();
-        glm::vec3 center = position;
-
-        for (int i = 0; i < c_numSegments; i++)
+        static std::unordered_map<uint32_t, Wireframe> s_wireframes;
+        auto [it, inserted] = s_wireframes.try_emplace(numSegments);
+        if (inserted)
         {
-            float theta1 = i * angleIncrement;
-            float theta2 = (i + 1) * angleIncrement;
-
-            glm::vec3 point1 = glm::vec3(radius * glm::cos(theta1), 0.0f, radius * glm::sin(theta1));
-            glm::vec3 point2 = glm::vec3(radius * glm::cos(theta2), 0.0f, radius * glm::sin(theta2));
-
-            // Rotate the points based on the transform's rotation
-            point1 = glm::rotate(rotation, point1) + center;
-            point2 = glm::rotate(rotation, point2) + center;
-
-            renderer.SubmitRenderJob({point1, point2, color});
+            const glm::vec3 x = glm::vec3(1.0f, 0.0f, 0.0f), y = glm::vec3(0.0f, 1.0f, 0.0f), z = glm::vec3(0.0f, 0.0f, 1.0f);
+            AddArc(it->second, numSegments, x, z, 0.0f, numSegments, 0.0f);
+            AddArc(it->second, numSegments, z, y, 0.0f, numSegments, 0.0f);
+            AddArc(it->second, numSegments, x, y, 0.0f, numSegments, 0.0f);
         }
+        return it->second;
+    }
 
-        for (int i = 0; i < c_numSegments / 2; i++)
+    // Unit radius, rings at both ends, the two hemispheres and four lines along the cylinder
+    static const Wireframe &GetCapsuleWireframe(uint32_t numSegments)
+    {
+        static std::unordered_map<uint32_t, Wireframe> s_wireframes;
+        auto [it, inserted] = s_wireframes.try_emplace(numSegments);
+        if (inserted)
         {
-            float phi1 = i * angleIncrement;
-            float phi2 = (i + 1) * angleIncrement;
-            float phi3 = i * angleIncrement - glm::radians(180.0f);
-            float phi4 = (i + 1) * angleIncrement - glm::radians(180.0f);
-
-            glm::vec3 point1 = glm::vec3(0.0f, radius * glm::sin(phi1), radius * glm::cos(phi1));
-            glm::vec3 point2 = glm::vec3(0.0f, radius * glm::sin(phi2), radius * glm::cos(phi2));
-            glm::vec3 point3 = glm::vec3(0.0f, radius * glm::sin(phi3), radius * glm::cos(phi3));
-            glm::vec3 point4 = glm::vec3(0.0f, radius * glm::sin(phi4), radius * glm::cos(phi4));
-
-            glm::vec3 point5 = glm::vec3(radius * glm::cos(phi1), radius * glm::sin(phi1), 0.0f);
-            glm::vec3 point6 = glm::vec3(radius * glm::cos(phi2), radius * glm::sin(phi2), 0.0f);
-            glm::vec3 point7 = glm::vec3(radius * glm::cos(phi3), radius * glm::sin(phi3), 0.0f);
-            glm::vec3 point8 = glm::vec3(radius * glm::cos(phi4), radius * glm::sin(phi4), 0.0f);
-
-            // Rotate the points based on the transform's rotation
-            point1 = glm::rotate(rotation, point1) + center;
-            point2 = glm::rotate(rotation, point2) + center;
-            point3 = glm::rotate(rotation, point3) + center;
-            point4 = glm::rotate(rotation, point4) + center;
-            point5 = glm::rotate(rotation, point5) + center;
-            point6 = glm::rotate(rotation, point6) + center;
-            point7 = glm::rotate(rotation, point7) + center;
-            point8 = glm::rotate(rotation, point8) + center;
-
-            renderer.SubmitRenderJob({point1, point2, color});
-            renderer.SubmitRenderJob({point3, point4, color});
-            renderer.SubmitRenderJob({point5, point6, color});
-            renderer.SubmitRenderJob({point7, point8, color});
+            Wireframe &wireframe = it->second;
+            const glm::vec3 x = glm::vec3(1.0f, 0.0f, 0.0f), y = glm::vec3(0.0f, 1.0f, 0.0f), z = glm::vec3(0.0f, 0.0f, 1.0f);
+            AddArc(wireframe, numSegments, x, z, 0.0f, numSegments, 1.0f);
+            AddArc(wireframe, numSegments, x, z, 0.0f, numSegments, -1.0f);
+            AddArc(wireframe, numSegments, z, y, 0.0f, numSegments / 2, 1.0f);
+            AddArc(wireframe, numSegments, z, y, -glm::pi<float>(), numSegments / 2, -1.0f);
+            AddArc(wireframe, numSegments, x, y, 0.0f, numSegments / 2, 1.0f);
+            AddArc(wireframe, numSegments, x, y, -glm::pi<float>(), numSegments / 2, -1.0f);
+
+            for (uint32_t i = 0; i < 4; i++)
+            {
+                const float theta = glm::half_pi<float>() * float(i);
+                const glm::vec3 point = glm::vec3(glm::cos(theta), 0.0f, glm::sin(theta));
+                const uint32_t first = static_cast<uint32_t>(wireframe.vertices.size());
+                wireframe.vertices.insert(wireframe.vertices.end(), {point, point});
+                wireframe.offsets.insert(wireframe.offsets.end(), {1.0f, -1.0f});
+                wireframe.edges.insert(wireframe.edges.end(), {first, first + 1});
+            }
         }
+        return it->second;
+    }
+
+    // Unit half extents
+    static const Wireframe &GetBoxWireframe()
+    {
+        static const Wireframe s_wireframe = {
+            .vertices = {
+                {-1.0f, -1.0f, -1.0f},
+                {-1.0f, -1.0f, 1.0f},
+                {-1.0f, 1.0f, -1.0f},
+                {-1.0f, 1.0f, 1.0f},
+                {1.0f, -1.0f, -1.0f},
+                {1.0f, -1.0f, 1.0f},
+                {1.0f, 1.0f, -1.0f},
+                {1.0f, 1.0f, 1.0f},
+            },
+            .offsets = {},
+            .edges = {0, 1, 1, 3, 3, 2, 2, 0, 4, 5, 5, 7, 7, 6, 6, 4, 0, 4, 1, 5, 2, 6, 3, 7},
+        };
+        return s_wireframe;
     }
 
-    void RenderShape(SceneRenderer &renderer, const glm::vec3 &position, const glm::quat &rotation, const CapsuleShape &capsuleShape, const glm::vec4 &color)
+    // Triangle edges with the ones shared by two triangles drawn once, rebuilt if the mesh data was replaced
+    static const Wireframe &GetMeshWireframe(const MeshShape &meshShape)
     {
-        const float angleIncrement = glm::radians(360.0f / c_numSegments);
-        glm::vec3 center = position;
-        const float radius = capsuleShape.GetRadius();
-        const float halfHeight = capsuleShape.GetHalfHeight();
+        static std::unordered_map<const void *, MeshWireframe> s_wireframes;
 
-        // Draw the top rings
-        for (int i = 0; i < c_numSegments; i++)
+        const std::weak_ptr<const void> data = meshShape.GetDataHandle();
+        MeshWireframe &entry = s_wireframes[data.lock().get()];
+        if (entry.data.owner_before(data) || data.owner_before(entry.data) || (entry.wireframe.vertices.empty() && !meshShape.GetVertices().empty()))
         {
-            float theta1 = i * angleIncrement;
-            float theta2 = (i + 1) * angleIncrement;
-
-            glm::vec3 point1 = glm::vec3(radius * glm::cos(theta1), 0.0f, radius * glm::sin(theta1)) + glm::vec3(0.0f, halfHeight, 0.0f);
-            glm::vec3 point2 = glm::vec3(radius * glm::cos(theta2), 0.0f, radius * glm::sin(theta2)) + glm::vec3(0.0f, halfHeight, 0.0f);
-            glm::vec3 point3 = glm::vec3(radius * glm::cos(theta1), 0.0f, radius * glm::sin(theta1)) + glm::vec3(0.0f, -halfHeight, 0.0f);
-            glm::vec3 point4 = glm::vec3(radius * glm::cos(theta2), 0.0f, radius * glm::sin(theta2)) + glm::vec3(0.0f, -halfHeight, 0.0f);
-
-            // Rotate the points based on the transform's rotation
-            point1 = glm::rotate(rotation, point1) + center;
-            point2 = glm::rotate(rotation, point2) + center;
-            point3 = glm::rotate(rotation, point3) + center;
-            point4 = glm::rotate(rotation, point4) + center;
-
-            renderer.SubmitRenderJob({point1, point2, color});
-            renderer.SubmitRenderJob({point3, point4, color});
+            entry.data = data;
+            entry.wireframe = {.vertices = meshShape.GetVertices(), .offsets = {}, .edges = {}};
+
+            const std::vector<uint32_t> &indices = meshShape.GetIndices();
+            std::unordered_set<uint64_t> edges;
+            edges.reserve(indices.size());
+            for (size_t i = 0; i + 2 < indices.size(); i += 3)
+            {
+                for (size_t j = 0; j < 3; j++)
+                {
+                    const uint32_t a = indices[i + j];
+                    const uint32_t b = indices[i + (j + 1) % 3];
+                    if (edges.insert((uint64_t(glm::min(a, b)) << 32) | glm::max(a, b)).second)
+                    {
+                        entry.wireframe.edges.insert(entry.wireframe.edges.end(), {a, b});
+                    }
+                }
+            }
         }
+        return entry.wireframe;
+    }
+
+    static void RenderWireframe(Renderer &renderer, const Wireframe &wireframe, const glm::vec3 &position, const glm::quat &rotation, const glm::vec3 &scale, float halfHeight, const glm::vec4 &color)
+    {
+        // Reused between calls, debug drawing only happens on the render thread
+        static std::vector<glm::vec3> s_points;
 
-        // Add lines to connect the poles to the equator
+        const glm::mat3 basis = glm::mat3_cast(rotation);
+        const glm::mat3 transform = glm::mat3(basis[0] * scale.x, basis[1] * scale.y, basis[2] * scale.z);
+        const glm::vec3 stretch = basis[1] * halfHeight;
 
-        for (int i = 0; i < c_numSegments / 2; i++)
+        s_points.resize(wireframe.vertices.size());
+        for (size_t i = 0; i < wireframe.vertices.size(); i++)
         {
-            float phi1 = i * angleIncrement;
-            float phi2 = (i + 1) * angleIncrement;
-            float phi3 = i * angleIncrement - glm::radians(180.0f);
-            float phi4 = (i + 1) * angleIncrement - glm::radians(180.0f);
-
-            glm::vec3 point1 = glm::vec3(0.0f, radius * glm::sin(phi1), radius * glm::cos(phi1)) + glm::vec3(0.0f, halfHeight, 0.0f);
-            glm::vec3 point2 = glm::vec3(0.0f, radius * glm::sin(phi2), radius * glm::cos(phi2)) + glm::vec3(0.0f, halfHeight, 0.0f);
-            glm::vec3 point3 = glm::vec3(0.0f, radius * glm::sin(phi3), radius * glm::cos(phi3)) + glm::vec3(0.0f, -halfHeight, 0.0f);
-            glm::vec3 point4 = glm::vec3(0.0f, radius * glm::sin(phi4), radius * glm::cos(phi4)) + glm::vec3(0.0f, -halfHeight, 0.0f);
-
-            glm::vec3 point5 = glm::vec3(radius * glm::cos(phi1), radius * glm::sin(phi1), 0.0f) + glm::vec3(0.0f, halfHeight, 0.0f);
-            glm::vec3 point6 = glm::vec3(radius * glm::cos(phi2), radius * glm::sin(phi2), 0.0f) + glm::vec3(0.0f, halfHeight, 0.0f);
-            glm::vec3 point7 = glm::vec3(radius * glm::cos(phi3), radius * glm::sin(phi3), 0.0f) + glm::vec3(0.0f, -halfHeight, 0.0f);
-            glm::vec3 point8 = glm::vec3(radius * glm::cos(phi4), radius * glm::sin(phi4), 0.0f) + glm::vec3(0.0f, -halfHeight, 0.0f);
-
-            // Rotate the points based on the transform's rotation
-            point1 = glm::rotate(rotation, point1) + center;
-            point2 = glm::rotate(rotation, point2) + center;
-            point3 = glm::rotate(rotation, point3) + center;
-            point4 = glm::rotate(rotation, point4) + center;
-            point5 = glm::rotate(rotation, point5) + center;
-            point6 = glm::rotate(rotation, point6) + center;
-            point7 = glm::rotate(rotation, point7) + center;
-            point8 = glm::rotate(rotation, point8) + center;
-
-            renderer.SubmitRenderJob({point1, point2, color});
-            renderer.SubmitRenderJob({point3, point4, color});
-            renderer.SubmitRenderJob({point5, point6, color});
-            renderer.SubmitRenderJob({point7, point8, color});
+            s_points[i] = position + transform * wireframe.vertices[i];
         }
 
-        // Draw the 4 lines connecting the top and bottom rings
-        for (int i = 0; i < 4; i++)
+        if (!wireframe.offsets.empty())
         {
-            float theta = glm::radians(i * 90.0f);
-
-            glm::vec3 point1 = glm::vec3(radius * glm::cos(theta), 0.0f, radius * glm::sin(theta)) + glm::vec3(0.0f, halfHeight, 0.0f);
-            glm::vec3 point2 = glm::vec3(radius * glm::cos(theta), 0.0f, radius * glm::sin(theta)) + glm::vec3(0.0f, -halfHeight, 0.0f);
-
-            // Rotate the points based on the transform's rotation
-            point1 = glm::rotate(rotation, point1);
-            point2 = glm::rotate(rotation, point2);
-
-            // Offset the points by the center of the sphere
-            point1 += center;
-            point2 += center;
+            for (size_t i = 0; i < wireframe.vertices.size(); i++)
+            {
+                s_points[i] += stretch * wireframe.offsets[i];
+            }
+        }
 
-            renderer.SubmitRenderJob({point1, point2, color});
+        for (size_t i = 0; i < wireframe.edges.size(); i += 2)
+        {
+            renderer.SubmitRenderJob({s_points[wireframe.edges[i]], s_points[wireframe.edges[i + 1]], color});
         }
     }
 
-    void RenderShape(SceneRenderer &renderer, const glm::vec3 &position, const glm::quat &rotation, const MeshShape &meshShape, const glm::vec4 &color)
+    void RenderShape(Renderer &renderer, const glm::vec3 &position, const glm::quat &rotation, const BoxShape &boxShape, const glm::vec4 &color)
     {
-        const std::vector<glm::vec3> &vertices = meshShape.GetVertices();
-        const std::vector<uint32_t> &indices = meshShape.GetIndices();
+        RenderWireframe(renderer, GetBoxWireframe(), position, rotation, boxShape.GetHalfExtents(), 0.0f, color);
+    }
 
-        for (size_t i = 0; i < indices.size(); i += 3)
-        {
-            glm::vec3 point1 = glm::rotate(rotation, vertices[indices[i]]) + position;
-            glm::vec3 point2 = glm::rotate(rotation, vertices[indices[i + 1]]) + position;
-            glm::vec3 point3 = glm::rotate(rotation, vertices[indices[i + 2]]) + position;
+    void RenderShape(Renderer &renderer, const glm::vec3 &position, const glm::quat &rotation, const SphereShape &sphereShape, const glm::vec4 &color)
+    {
+        RenderWireframe(renderer, GetSphereWireframe(c_numSegments), position, rotation, glm::vec3(sphereShape.GetRadius()), 0.0f, color);
+    }
 
-            renderer.SubmitRenderJob({point1, point2, color});
-            renderer.SubmitRenderJob({point2, point3, color});
-            renderer.SubmitRenderJob({point3, point1, color});
-        }
+    void RenderShape(Renderer &renderer, const glm::vec3 &position, const glm::quat &rotation, const CapsuleShape &capsuleShape, const glm::vec4 &color)
+    {
+        RenderWireframe(renderer, GetCapsuleWireframe(c_numSegments), position, rotation, glm::vec3(capsuleShape.GetRadius()), capsuleShape.GetHalfHeight(), color);
     }
 
-    void RenderCollision(SceneRenderer &renderer, const glm::vec3 &position, const glm::quat &rotation, const CollisionData &collision)
+    void RenderShape(Renderer &renderer, const glm::vec3 &position, const glm::quat &rotation, const MeshShape &meshShape, const glm::vec4 &color)
+    {
+        RenderWireframe(renderer, GetMeshWireframe(meshShape), position, rotation, glm::vec3(1.0f), 0.0f, color);
+    }
+
+    void RenderCollision(Renderer &renderer, const glm::vec3 &position, const glm::quat &rotation, const CollisionData &collision)
     {
         glm::vec4 color = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
         switch (collision.layer)
@@ -206,6 +207,9 @@ namespace mk::PhysicsRenderingHelper
         case ObjectLayer::NonMoving:
             color = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
             break;
+        case ObjectLayer::Debris:
+            color = glm::vec4(0.5f, 0.5f, 0.5f, 1.0f);
+            break;
         default:
             break;
         }
@@ -214,4 +218,4 @@ namespace mk::PhysicsRenderingHelper
                    { RenderShape(renderer, position, rotation, arg, color); },
                    collision.shape);
     }
-}
\ No newline at end of file
+}
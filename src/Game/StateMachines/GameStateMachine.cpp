@@ -10,7 +10,10 @@
 
 #include <glm/glm.hpp>
 
+#include <iomanip>
+#include <random>
 #include <ranges>
+#include <sstream>
 
 // Undefine windows.h macro for CreateEvent
 #ifdef CreateEvent
@@ -62,6 +65,12 @@ namespace mk
     template <typename... Components>
     using EntityList = std::vector<Entity<Components...>>;
 
+    template <typename T>
+    size_t GetReservedBytes(const std::vector<T> &list)
+    {
+        return list.capacity() * sizeof(T);
+    }
+
     template <typename... Components>
     Entity<Components...> CreateEntity(Components &&...components)
     {
@@ -199,6 +208,38 @@ namespace mk
     const RenderHandle c_fontMaterialHandle = GetHandle("FontMaterial");
     const RenderHandle c_fontAtlasHandle = GetHandle(MK_ASSET_PATH("ui/font_msdf.dat"));
 
+    bool g_showDebugOverlay = false;
+
+    void RenderDebugOverlay(Renderer &renderer)
+    {
+        constexpr float c_kiB = 1.0f / 1024.0f;
+        constexpr float c_lineHeight = 0.05f;
+        const DebugInfo &debugInfo = Application::GetDebugInfo();
+        const MemoryInfo &memory = debugInfo.memory;
+
+        std::vector<std::string> lines;
+        const auto addLine = [&](auto &&...args)
+        {
+            std::stringstream ss;
+            ss << std::fixed << std::setprecision(2);
+            (ss << ... << args);
+            lines.push_back(ss.str());
+        };
+
+        addLine("Physics ", debugInfo.physicsTime, " ms, update ", debugInfo.updateTime, " ms, render ", debugInfo.renderTime, " ms");
+        addLine("Fixed steps per frame ", debugInfo.fixedSteps, ", dropped ", debugInfo.droppedTime * 1000.0f, " ms");
+        addLine("Entities ", (memory.entityStoreBytes + memory.entityListBytes) * c_kiB, " KiB");
+        addLine("Physics temp peak ", memory.physicsTempPeakBytes * c_kiB, " / ", memory.physicsTempCapacity * c_kiB, " KiB");
+        addLine("Particle jobs ", memory.numParticleJobs, " (", memory.particleJobBytes * c_kiB, " KiB)");
+        addLine("Audio events ", memory.numAudioEvents);
+        addLine("Renderer ", memory.rendererBytes * c_kiB * c_kiB, " MiB");
+
+        for (uint32_t i = 0; i < lines.size(); i++)
+        {
+            UIHelper::RenderText(renderer, c_fontAtlasHandle, c_fontMaterialHandle, lines[i], glm::vec2(-0.95f, -0.9f + i * c_lineHeight), 0.5f, glm::vec4(1.0f, 1.0f, 1.0f, 0.8f), TextAlignment::Left);
+        }
+    }
+
     GameStateMachine::OptionalState GameStateImpl::TransitionAnyTo(const GameStateMachine::State &state)
     {
         return std::nullopt;
@@ -218,7 +259,7 @@ namespace mk
                 audioSystem.LoadBank(MK_ASSET_PATH("/audio/monke/Build/Desktop/Master.bank"), BankType::Master);
                 audioSystem.LoadBank(MK_ASSET_PATH("/audio/monke/Build/Desktop/Master.strings.bank"), BankType::Strings);
 
-                auto &renderer = const_cast<SceneRenderer &>(Application::GetRenderer());
+                auto &renderer = const_cast<Renderer &>(Application::GetRenderer());
 
                 // Load assets
                 renderer.CreateMaterial<SpriteMaterial>(
@@ -366,6 +407,19 @@ namespace mk
                 renderer.LoadMesh(MK_ASSET_PATH("models/drone/drone.dat"), true);
                 renderer.LoadMesh(MK_ASSET_PATH("models/tree/tree.dat"), true);
 
+                // Collision shapes baked offline with -bakeshapes, the hull is built at spawn if the sidecar is missing
+                {
+                    const std::string dronePath = MK_ASSET_PATH("models/drone/drone.dat");
+                    const RenderHandle droneHandle = GetHandle(dronePath);
+#ifndef MK_HEADLESS
+                    if (Application::GetCmdArgs().HasFlag("-bakeshapes"))
+                    {
+                        ShapeBaking::BakeShape(BakedShapeType::ConvexHull, renderer.GetMeshVertices(droneHandle), renderer.GetMeshIndices(droneHandle), ShapeBaking::GetSidecarPath(dronePath));
+                    }
+#endif
+                    Application::GetPhysicsWorld().GetShapeCache().LoadBakedShape(droneHandle, ShapeBaking::GetSidecarPath(dronePath));
+                }
+
                 renderer.CreateMaterial<PBRMaterial>(
                     "ParticleAtlasMaterial",
                     {
@@ -402,7 +456,7 @@ namespace mk
     {
     }
 
-    void GameStateImpl::OnRender(Vultron::SceneRenderer &renderer, GameStates::InitialLoadState &state)
+    void GameStateImpl::OnRender(Renderer &renderer, GameStates::InitialLoadState &state)
     {
         UIHelper::RenderText(renderer, c_fontAtlasHandle, c_fontMaterialHandle, "Loading...", glm::vec2(0.0f, 0.0f), 1.0f, glm::vec4(1.0f, 1.0f, 1.0f, 1.0f));
     }
@@ -447,7 +501,7 @@ namespace mk
     {
     }
 
-    void GameStateImpl::OnRender(Vultron::SceneRenderer &renderer, GameStates::MainMenuState &state)
+    void GameStateImpl::OnRender(Renderer &renderer, GameStates::MainMenuState &state)
     {
         float time = Application::GetTimeSinceStart();
         float blink = glm::mix(glm::sin(time * 3.0f) * 0.5f + 0.5f, 1.0f, 0.25f);
@@ -496,7 +550,7 @@ namespace mk
     {
     }
 
-    void GameStateImpl::OnRender(Vultron::SceneRenderer &renderer, GameStates::LoadingState &state)
+    void GameStateImpl::OnRender(Renderer &renderer, GameStates::LoadingState &state)
     {
         UIHelper::RenderText(renderer, c_fontAtlasHandle, c_fontMaterialHandle, "Loading scene...", glm::vec2(0.0f, 0.0f), 1.0f, glm::vec4(1.0f, 1.0f, 1.0f, 1.0f));
     }
@@ -543,7 +597,12 @@ namespace mk
 
         std::array<Tile, c_tilesPerRow * c_tilesPerRow> tiles;
         BodyID floorBodyID = 0;
+
+        ProjectilePoolID rocketPool = c_invalidProjectilePoolID;
+        ProjectilePoolID heavyBulletPool = c_invalidProjectilePoolID;
         std::vector<int32_t> nonCorruptedTiles;
+        // Reused by rocket splash overlaps, grown when a dense wave does not fit
+        std::vector<OverlapResult> splashHits = std::vector<OverlapResult>(64);
 
         DynamicTimer waveTimer = DynamicTimer(false);
         uint32_t wave = 0;
@@ -553,9 +612,17 @@ namespace mk
 
         std::vector<ParticleEmitJob> particleJobs;
 
+        // Reused every fixed update to read back all awake body states in one batch
+        std::vector<BodyID> syncBodyIDs;
+        std::vector<PhysicsProxy *> syncProxies;
+        std::vector<RigidBodyState> syncBodyStates;
+
         float startTime = 0.0f;
 
         bool isGameOver = false;
+
+        // Seeded from the session on every new run, so the same seed and input replay the same game
+        std::mt19937 random;
     } g_entityStore;
 
     WeaponEntity &GetCurrentPlayerWeapon()
@@ -634,7 +701,7 @@ namespace mk
 
     void CreateEnemy(EnemyType type, glm::vec3 position)
     {
-        auto &renderer = const_cast<SceneRenderer &>(Application::GetRenderer());
+        auto &renderer = const_cast<Renderer &>(Application::GetRenderer());
         auto &physicsWorld = Application::GetPhysicsWorld();
 
         auto meshHandle = GetHandle(MK_ASSET_PATH("models/drone/drone.dat"));
@@ -672,9 +739,16 @@ namespace mk
                 .initialVelocity = glm::vec3(0.0f),
                 .mass = 1.0f,
                 .friction = 1.0f,
-                .continuousCollision = false,
+                .motionQuality = MotionQuality::Discrete,
                 .gravityFactor = 0.0f,
-                .shape = MeshShape(renderer.GetMeshVertices(meshHandle), renderer.GetMeshIndices(meshHandle), c_enemyTransform[type]),
+                .shape = physicsWorld.GetShapeCache().GetOrCreate(
+                    {.source = meshHandle, .type = CollisionShapeType::Mesh, .transform = c_enemyTransform[type]},
+                    [&]()
+                    {
+                        MeshShape shape(renderer.GetMeshVertices(meshHandle), renderer.GetMeshIndices(meshHandle), c_enemyTransform[type]);
+                        physicsWorld.GetShapeCache().ApplyBakedShape(meshHandle, c_enemyTransform[type], shape);
+                        return shape;
+                    }),
                 .layer = ObjectLayer::Enemy,
             },
             BodyType::Rigidbody);
@@ -708,11 +782,12 @@ namespace mk
             assert(i == j);
         }
 
-        auto &renderer = const_cast<SceneRenderer &>(Application::GetRenderer());
+        auto &renderer = const_cast<Renderer &>(Application::GetRenderer());
         auto &physicsWorld = Application::GetPhysicsWorld();
         auto &audioSystem = Application::GetAudioSystem();
 
         g_entityStore = {};
+        g_entityStore.random.seed(Application::GetRandomSeed());
         g_entityStore.startTime = Application::GetTimeSinceStart();
 
         glm::vec3 playerPosition = glm::vec3(0.0f, 0.0f, 0.0f);
@@ -727,11 +802,11 @@ namespace mk
                         .initialVelocity = glm::vec3(0.0f),
                         .mass = 1.0f,
                         .friction = 0.0f,
-                        .continuousCollision = true,
+                        .motionQuality = MotionQuality::LinearCast,
                         .shape = CapsuleShape(35.0f, 49.0f),
                         .layer = ObjectLayer::Player,
                     },
-                    BodyType::Character),
+                    Application::GetCmdArgs().HasFlag("-virtualcharacter") ? BodyType::VirtualCharacter : BodyType::Character),
             },
             PlayerMovement{
                 .dashSpeed = 2000.0f,
@@ -840,7 +915,7 @@ namespace mk
                 .initialVelocity = glm::vec3(0.0f),
                 .mass = 0.0f,
                 .friction = 0.0f,
-                .continuousCollision = false,
+                .motionQuality = MotionQuality::Discrete,
                 .shape = BoxShape(glm::vec3(c_tilesPerRow * c_tileSize * c_tileScale / 2.0f, 10.0f, c_tilesPerRow * c_tileSize * c_tileScale / 2.0f)),
                 .layer = ObjectLayer::NonMoving,
             },
@@ -848,6 +923,11 @@ namespace mk
 
         physicsWorld.RegisterContactListener(g_entityStore.floorBodyID);
 
+        // Small bullets are raycast projectiles, rockets and the large heavy bullets keep a body.
+        // Pools persist in the physics world so this only creates them once.
+        g_entityStore.rocketPool = physicsWorld.GetProjectilePool({.radius = 10.0f, .layer = ObjectLayer::PlayerProjectile, .capacity = 8});
+        g_entityStore.heavyBulletPool = physicsWorld.GetProjectilePool({.radius = 50.0f, .layer = ObjectLayer::EnemyProjectile, .capacity = 16});
+
         g_entityStore.tiles.fill({});
 
         renderer.SetParticleAtlasMaterial(GetHandle("ParticleAtlasMaterial"));
@@ -865,6 +945,11 @@ namespace mk
             state.shouldExitGame = true;
         }
 
+        if (inputState.Pressed(InputActionType::DebugOption2))
+        {
+            g_showDebugOverlay = !g_showDebugOverlay;
+        }
+
         if (inputState.Pressed(InputActionType::DebugOption1))
         {
             g_debugCamera.active = !g_debugCamera.active;
@@ -1176,19 +1261,9 @@ namespace mk
                 float scale = 0.1f;
                 glm::vec4 color = glm::vec4(0.0f, 5.0f, 10.0f, 1.0f);
 
-                auto bodyId = physicsWorld.CreateRigidBody(
-                    {
-                        .position = position,
-                        .rotation = rotation,
-                        .initialVelocity = velocity,
-                        .mass = 1.0f,
-                        .friction = 0.0f,
-                        .continuousCollision = true,
-                        .gravityFactor = emitter.gravity,
-                        .shape = SphereShape(scale * 100.0f),
-                        .layer = ObjectLayer::PlayerProjectile,
-                    },
-                    BodyType::Rigidbody);
+                auto bodyId = emitter.type == ProjectileType::Rocket
+                                  ? physicsWorld.AcquireProjectileBody(g_entityStore.rocketPool, position, rotation, velocity, emitter.gravity)
+                                  : physicsWorld.CreateRaycastProjectile(ObjectLayer::PlayerProjectile, position, rotation, velocity, emitter.gravity);
                 physicsWorld.RegisterContactListener(bodyId);
                 auto currentState = physicsWorld.GetRigidBodyState(bodyId);
                 auto previousState = currentState;
@@ -1223,7 +1298,7 @@ namespace mk
                 }
             }
 
-            std::shuffle(g_entityStore.nonCorruptedTiles.begin(), g_entityStore.nonCorruptedTiles.end(), std::default_random_engine());
+            std::shuffle(g_entityStore.nonCorruptedTiles.begin(), g_entityStore.nonCorruptedTiles.end(), g_entityStore.random);
         }
 
         // Reset tile amount
@@ -1239,6 +1314,7 @@ namespace mk
             if (g_entityStore.waveTimer.Tick(dt))
             {
                 g_entityStore.wave++;
+                state.wave = g_entityStore.wave;
                 g_entityStore.waveTimer.Reset(glm::mix(20.0f, 40.0f, glm::clamp(static_cast<float>(g_entityStore.wave) / 10.0f, 0.0f, 1.0f)));
                 int32_t numEnemies = 8 + g_entityStore.wave * 2;
                 for (int i = 0; i < numEnemies; i++)
@@ -1248,7 +1324,7 @@ namespace mk
                     CreateEnemy(EnemyType::Drone, position);
                 }
 
-                float offsetAngle = glm::radians(static_cast<float>(rand() % 360));
+                float offsetAngle = glm::radians(static_cast<float>(g_entityStore.random() % 360));
                 // Spawn a small wave of fast enemies, make it in a cluster
                 int32_t numFastEnemies = g_entityStore.wave % 2 == 0 ? (4 + g_entityStore.wave) : 0;
                 for (int i = 0; i < numFastEnemies; i++)
@@ -1258,7 +1334,7 @@ namespace mk
                     CreateEnemy(EnemyType::Fast, position);
                 }
 
-                offsetAngle = glm::radians(static_cast<float>(rand() % 360));
+                offsetAngle = glm::radians(static_cast<float>(g_entityStore.random() % 360));
                 int32_t numHeavyEnemies = static_cast<int32_t>(glm::floor(0.25f * g_entityStore.wave));
                 for (int i = 0; i < numHeavyEnemies; i++)
                 {
@@ -1286,6 +1362,7 @@ namespace mk
                 if (health.current <= 0.0f)
                 {
                     physicsWorld.SetGravityFactor(proxy.bodyID, 1.0f);
+                    physicsWorld.SetDebris(proxy.bodyID);
 
                     // Stop audio event
                     if (soundEmitter.event.has_value())
@@ -1308,7 +1385,7 @@ namespace mk
                             },
                             Lifetime{.timer = DynamicTimer(5.0f)}));
 
-                    SceneRenderer &renderer = const_cast<SceneRenderer &>(Application::GetRenderer());
+                    Renderer &renderer = const_cast<Renderer &>(Application::GetRenderer());
                     ParticleHelper::SpawnExplosionEffect(g_entityStore.particleJobs, transform.position);
                     Application::GetAudioSystem().PlayEventAtPosition("event:/enemy/death", transform.position, glm::vec3(0.0f));
 
@@ -1378,7 +1455,7 @@ namespace mk
                             else
                             {
                                 // Random tile
-                                ai.target = GetTilePosition(rand() % g_entityStore.tiles.size());
+                                ai.target = GetTilePosition(g_entityStore.random() % g_entityStore.tiles.size());
                             }
                         }
 
@@ -1393,7 +1470,7 @@ namespace mk
 
                     if (glm::length(direction) > glm::epsilon<float>())
                     {
-                        physicsWorld.SetLinearVelocity(
+                        physicsWorld.QueueLinearVelocity(
                             proxy.bodyID,
                             direction * 300.0f);
                     }
@@ -1402,7 +1479,7 @@ namespace mk
                     if (glm::length(enemyToPlayer) > 100.0f)
                     {
                         glm::quat rotation = glm::normalize(glm::quatLookAt(glm::normalize(enemyToPlayer), glm::vec3(0.0f, 1.0f, 0.0f)));
-                        physicsWorld.SetRotation(
+                        physicsWorld.QueueRotation(
                             proxy.bodyID,
                             rotation);
                     }
@@ -1419,10 +1496,10 @@ namespace mk
                     {
                         glm::vec3 direction = glm::normalize(enemyToPlayer);
                         glm::quat rotation = glm::normalize(glm::quatLookAt(direction, glm::vec3(0.0f, 1.0f, 0.0f)));
-                        physicsWorld.SetRotation(
+                        physicsWorld.QueueRotation(
                             proxy.bodyID,
                             rotation);
-                        physicsWorld.SetLinearVelocity(
+                        physicsWorld.QueueLinearVelocity(
                             proxy.bodyID,
                             direction * 800.0f);
                     }
@@ -1452,10 +1529,10 @@ namespace mk
 
                     glm::vec3 direction = glm::normalize(enemyToPlayer);
                     glm::quat rotation = glm::normalize(glm::quatLookAt(direction, glm::vec3(0.0f, 1.0f, 0.0f)));
-                    physicsWorld.SetRotation(
+                    physicsWorld.QueueRotation(
                         proxy.bodyID,
                         rotation);
-                    physicsWorld.SetLinearVelocity(
+                    physicsWorld.QueueLinearVelocity(
                         proxy.bodyID,
                         ai.isAttacking ? glm::vec3(0.0f) : direction * 300.0f);
                 }
@@ -1488,19 +1565,7 @@ namespace mk
                                 float scale = 0.1f;
                                 glm::vec4 color = glm::vec4(10.0f, 0.0f, 0.0f, 1.0f);
 
-                                auto bodyId = physicsWorld.CreateRigidBody(
-                                    {
-                                        .position = position,
-                                        .rotation = rotation,
-                                        .initialVelocity = velocity,
-                                        .mass = 1.0f,
-                                        .friction = 0.0f,
-                                        .continuousCollision = true,
-                                        .gravityFactor = 0.0f,
-                                        .shape = SphereShape(scale * 100.0f),
-                                        .layer = ObjectLayer::EnemyProjectile,
-                                    },
-                                    BodyType::Rigidbody);
+                                auto bodyId = physicsWorld.CreateRaycastProjectile(ObjectLayer::EnemyProjectile, position, rotation, velocity);
                                 physicsWorld.RegisterContactListener(bodyId);
                                 auto currentState = physicsWorld.GetRigidBodyState(bodyId);
                                 auto previousState = currentState;
@@ -1521,7 +1586,7 @@ namespace mk
                                     Lifetime{.timer = DynamicTimer(5.0f)}));
                             }
 
-                            ai.shootTimer.Reset(2.0f + static_cast<float>(rand() % 6));
+                            ai.shootTimer.Reset(2.0f + static_cast<float>(g_entityStore.random() % 6));
                         }
                     }
                     else if (type == EnemyType::Heavy)
@@ -1538,19 +1603,7 @@ namespace mk
                                 float scale = 0.5f;
                                 glm::vec4 color = glm::vec4(0.0f, 0.0f, 10.0f, 1.0f);
 
-                                auto bodyId = physicsWorld.CreateRigidBody(
-                                    {
-                                        .position = position,
-                                        .rotation = rotation,
-                                        .initialVelocity = velocity,
-                                        .mass = 1.0f,
-                                        .friction = 0.0f,
-                                        .continuousCollision = true,
-                                        .gravityFactor = 0.0f,
-                                        .shape = SphereShape(scale * 100.0f),
-                                        .layer = ObjectLayer::EnemyProjectile,
-                                    },
-                                    BodyType::Rigidbody);
+                                auto bodyId = physicsWorld.AcquireProjectileBody(g_entityStore.heavyBulletPool, position, rotation, velocity);
                                 physicsWorld.RegisterContactListener(bodyId);
                                 auto currentState = physicsWorld.GetRigidBodyState(bodyId);
                                 auto previousState = currentState;
@@ -1612,7 +1665,7 @@ namespace mk
             {
                 if (!g_entityStore.enemies.empty())
                 {
-                    int32_t randomIndex = rand() % g_entityStore.enemies.size();
+                    int32_t randomIndex = static_cast<int32_t>(g_entityStore.random() % g_entityStore.enemies.size());
 
                     auto &enemy = g_entityStore.enemies[randomIndex];
                     if (enemy.GetComponent<EnemyType>() != EnemyType::Fast)
@@ -1623,7 +1676,7 @@ namespace mk
                         audioSystem.PlayEventAtPosition(soundEmitter.event.value(), enemy.GetComponent<Transform>().position, enemy.GetComponent<PhysicsProxy>().currentState.linearVelocity);
                     }
 
-                    g_entityStore.enemySoundTimer.Reset(float(rand() % 5));
+                    g_entityStore.enemySoundTimer.Reset(float(g_entityStore.random() % 5));
                 }
             }
 
@@ -1638,6 +1691,17 @@ namespace mk
                 },
                 g_entityStore.enemies);
         }
+
+        // Memory telemetry
+        {
+            MemoryInfo &memory = Application::GetDebugInfo().memory;
+            memory.entityListBytes =
+                GetReservedBytes(g_entityStore.staticEntities) +
+                GetReservedBytes(g_entityStore.projectiles) +
+                GetReservedBytes(g_entityStore.enemies) +
+                GetReservedBytes(g_entityStore.nonCorruptedTiles) +
+                g_entityStore.damageEvents.size() * sizeof(decltype(g_entityStore.damageEvents)::value_type);
+        }
     }
 
     void GameStateImpl::OnFixedUpdate(float dt, uint32_t numSteps, PhysicsWorld &physicsWorld, GameStates::PlayingState &state)
@@ -1677,16 +1741,38 @@ namespace mk
 
         // Physics system
         {
-            ForEach<Transform, PhysicsProxy>(
-                [&](Transform &transform, PhysicsProxy &proxy)
+            auto &bodyIDs = g_entityStore.syncBodyIDs;
+            auto &proxies = g_entityStore.syncProxies;
+            auto &bodyStates = g_entityStore.syncBodyStates;
+            bodyIDs.clear();
+            proxies.clear();
+
+            ForEach<PhysicsProxy>(
+                [&](PhysicsProxy &proxy)
                 {
-                    proxy.previousState = proxy.currentState;
-                    proxy.currentState = physicsWorld.GetRigidBodyState(proxy.bodyID);
+                    // Sleeping bodies, mostly settled debris, have not moved since the last step
+                    if (!physicsWorld.IsBodyActive(proxy.bodyID))
+                    {
+                        proxy.previousState = proxy.currentState;
+                        return;
+                    }
+
+                    bodyIDs.push_back(proxy.bodyID);
+                    proxies.push_back(&proxy);
                 },
                 g_entityStore.playerEntity,
                 g_entityStore.staticEntities,
                 g_entityStore.projectiles,
                 g_entityStore.enemies);
+
+            bodyStates.resize(bodyIDs.size());
+            physicsWorld.GetRigidBodyStates(bodyIDs, bodyStates);
+
+            for (size_t i = 0; i < proxies.size(); i++)
+            {
+                proxies[i]->previousState = proxies[i]->currentState;
+                proxies[i]->currentState = bodyStates[i];
+            }
         }
 
         // Projectiles trail system
@@ -1772,20 +1858,27 @@ namespace mk
                                 constexpr float c_falloffFactor = 0.5f * c_radius;
                                 ParticleHelper::SpawnIceExplosionEffect(g_entityStore.particleJobs, contact.position);
                                 Application::GetAudioSystem().PlayEventAtPosition("event:/explosion", contact.position, glm::vec3(0.0f));
-                                std::vector<BodyID> hitBodies = physicsWorld.CastSphere(contact.position, c_radius);
-                                for (auto &hitBody : hitBodies)
+                                // Only bodies that can take damage or be pushed, not the floor or other projectiles. Dying
+                                // enemies are debris and still get thrown around like before they had their own layer.
+                                const ObjectLayerMask splashLayers = GetObjectLayerMask(ObjectLayer::Player, ObjectLayer::Enemy, ObjectLayer::Moving, ObjectLayer::Debris);
+                                std::vector<OverlapResult> &hits = g_entityStore.splashHits;
+                                const uint32_t numHits = physicsWorld.OverlapSphere(contact.position, c_radius, hits, splashLayers);
+                                if (numHits > hits.size())
                                 {
-                                    if (hitBody != proxy.bodyID)
-                                    {
-                                        glm::vec3 position = physicsWorld.GetPosition(hitBody);
-                                        float distance = glm::length(position - contact.position);
-                                        float falloff = 1.0f / (1.0f + glm::pow(distance / c_falloffFactor, 2.0f));
-
-                                        g_entityStore.damageEvents[hitBody] += 200.0f * falloff;
-                                        physicsWorld.SetLinearVelocity(
-                                            hitBody,
-                                            (glm::normalize(position - contact.position) + glm::vec3(0.0f, 0.5f, 0.0f)) * c_explosionStrength * falloff);
-                                    }
+                                    hits.resize(numHits);
+                                    physicsWorld.OverlapSphere(contact.position, c_radius, hits, splashLayers);
+                                }
+
+                                for (uint32_t i = 0; i < numHits; i++)
+                                {
+                                    const OverlapResult &hit = hits[i];
+                                    float distance = glm::length(hit.position - contact.position);
+                                    float falloff = 1.0f / (1.0f + glm::pow(distance / c_falloffFactor, 2.0f));
+
+                                    g_entityStore.damageEvents[hit.body] += 200.0f * falloff;
+                                    physicsWorld.SetLinearVelocity(
+                                        hit.body,
+                                        (glm::normalize(hit.position - contact.position) + glm::vec3(0.0f, 0.5f, 0.0f)) * c_explosionStrength * falloff);
                                 }
                             }
                             break;
@@ -1828,7 +1921,7 @@ namespace mk
         }
     }
 
-    void GameStateImpl::OnRender(Vultron::SceneRenderer &renderer, GameStates::PlayingState &state)
+    void GameStateImpl::OnRender(Renderer &renderer, GameStates::PlayingState &state)
     {
         std::array<PointLightData, 4> pointsLights = {};
 
@@ -1966,9 +2059,9 @@ namespace mk
             {
                 // Plus minus half the tile size
                 glm::vec3 position = tilePosition + glm::vec3(
-                                                        (rand() % 1000) / 1000.0f - 0.5f,
+                                                        (g_entityStore.random() % 1000) / 1000.0f - 0.5f,
                                                         0.0f,
-                                                        (rand() % 1000) / 1000.0f - 0.5f) *
+                                                        (g_entityStore.random() % 1000) / 1000.0f - 0.5f) *
                                                         c_tileSize * c_tileScale;
                 // ParticleHelper::SpawnSpark(g_entityStore.particleJobs, position);
             }
@@ -2091,6 +2184,14 @@ namespace mk
             });
         }
 
+        // Memory telemetry, particle jobs are sampled before they are flushed below
+        {
+            MemoryInfo &memory = Application::GetDebugInfo().memory;
+            memory.numParticleJobs = static_cast<uint32_t>(g_entityStore.particleJobs.size());
+            memory.particleJobBytes = GetReservedBytes(g_entityStore.particleJobs);
+            memory.rendererBytes = renderer.GetMemoryUsage();
+        }
+
         // Particle emitters
         {
             for (auto &job : g_entityStore.particleJobs)
@@ -2101,9 +2202,9 @@ namespace mk
             g_entityStore.particleJobs.clear();
         }
 
+        if (g_showDebugOverlay)
         {
-            // Render
-            size_t mem = renderer.GetMemoryUsage();
+            RenderDebugOverlay(renderer);
         }
 
         renderer.SetPointLights(pointsLights);
@@ -2151,7 +2252,7 @@ namespace mk
             Application::WritePersistentData();
         }
 
-        auto &renderer = const_cast<SceneRenderer &>(Application::GetRenderer());
+        auto &renderer = const_cast<Renderer &>(Application::GetRenderer());
         renderer.SetSkybox(std::nullopt);
         renderer.SetEnvironmentMap(std::nullopt);
 
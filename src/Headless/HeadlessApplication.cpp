@@ -0,0 +1,229 @@
+#include "Application.h"
+
+#include "Core/EntityStore.h"
+#include "Core/Logger.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace mk
+{
+    // Application implementation for the headless build. There is no window, renderer or audio device,
+    // input comes from a fixed script and time advances by exactly one fixed update per tick. This makes
+    // it possible to run the gameplay and physics code as a benchmark or in CI.
+
+    Application *Application::s_instance = nullptr;
+
+    constexpr uint32_t c_defaultNumWaves = 5;
+    constexpr float c_scriptLookSpeed = 0.6f; // Radians per second
+    constexpr float c_scriptStrafePeriod = 8.0f;
+    constexpr uint64_t c_scriptAttackPeriod = 15; // Ticks
+    constexpr uint64_t c_scriptJumpPeriod = 3 * 60;
+    constexpr uint64_t c_scriptDashPeriod = 5 * 60;
+    constexpr uint64_t c_scriptSwitchWeaponPeriod = 10 * 60;
+
+    bool Application::Initialize()
+    {
+        InitializeRandom();
+
+        // Every tick simulates exactly its fixed update however long it takes, so runs of the same script step
+        // the same and their checksums can be compared
+        m_fixedStepScheduler = FixedStepScheduler({
+            .interval = c_fixedUpdateInterval,
+            .maxStepsPerFrame = c_maxSubSteps,
+            .stepsPerBatch = 1,
+            .maxStepTime = 0.0f,
+        });
+
+        if (!m_audioSystem.Initialize())
+        {
+            std::cerr << "AudioSystem failed to initialize" << std::endl;
+            return false;
+        }
+
+        m_physicsWorld.Initialize(PhysicsWorldSettings::FromCmdArgs(m_cmdArgs));
+
+        m_game.OnInitialize();
+
+        return true;
+    }
+
+    void Application::UpdateScriptedInput(uint64_t tick)
+    {
+        InputState state = {};
+
+        const float time = tick * c_fixedUpdateInterval;
+        const float strafeAngle = time * glm::two_pi<float>() / c_scriptStrafePeriod;
+        state.movementAxis = glm::vec2(glm::sin(strafeAngle), glm::cos(strafeAngle));
+        state.lookAxis = glm::vec2(c_scriptLookSpeed * c_fixedUpdateInterval, 0.0f);
+
+        // Release the trigger now and then so that semi automatic weapons fire as well
+        state.Set(tick % c_scriptAttackPeriod != 0, InputActionType::Attack);
+        state.Set(tick % c_scriptJumpPeriod == 0, InputActionType::Jump);
+        state.Set(tick % c_scriptDashPeriod == 0, InputActionType::Dash);
+        state.Set(tick % c_scriptSwitchWeaponPeriod == 0, InputActionType::NextOption);
+
+        state.beginActions = state.actions & ~m_inputState.actions;
+        state.endActions = ~state.actions & m_inputState.actions;
+
+        m_inputState = state;
+    }
+
+    void Application::Update(float dt)
+    {
+        Logger::GetInstance().Update(dt);
+        m_game.OnUpdate(dt, m_audioSystem, m_physicsWorld, m_inputState);
+
+        m_eventBus.Update();
+        m_audioSystem.Update();
+
+        SampleMemoryInfo();
+    }
+
+    void Application::SampleMemoryInfo()
+    {
+        // Game side entries are filled in by the game itself during update and render
+        MemoryInfo &memory = m_debugInfo.memory;
+        memory.entityStoreBytes = MemoryAllocator::get_total_allocated_memory();
+        memory.physicsTempPeakBytes = m_physicsWorld.GetTempAllocatorPeakUsage();
+        memory.physicsTempCapacity = m_physicsWorld.GetTempAllocatorSize();
+        memory.numAudioEvents = static_cast<uint32_t>(m_audioSystem.GetNumEvents());
+    }
+
+    void Application::FixedUpdate(float dt, uint32_t numSubSteps)
+    {
+        m_game.OnFixedUpdate(dt, numSubSteps, m_physicsWorld);
+    }
+
+    void Application::Render()
+    {
+        m_game.OnRender(m_renderer);
+    }
+
+    void Application::Shutdown()
+    {
+        m_game.OnShutdown();
+        m_physicsWorld.Shutdown();
+        m_audioSystem.Shutdown();
+    }
+
+    uint32_t Application::Run(int argc, char **argv)
+    {
+        m_cmdArgs = CmdArgs::Parse(argc, argv);
+
+        const uint32_t numWaves = m_cmdArgs.GetOptionNumber<uint32_t>("-waves").value_or(c_defaultNumWaves);
+        const uint64_t memoryLogTicks = static_cast<uint64_t>(c_memoryLogInterval / c_fixedUpdateInterval);
+
+        if (!Initialize())
+        {
+            return EXIT_FAILURE;
+        }
+
+        // -checksums <file> writes the world checksum of every tick, diff two files to find the first diverging tick
+        std::ofstream checksumFile;
+        if (const std::string checksumPath = m_cmdArgs.GetOptionValue("-checksums"); !checksumPath.empty())
+        {
+            checksumFile.open(checksumPath);
+            if (!checksumFile.is_open())
+            {
+                std::cerr << "Failed to open checksum file: " << checksumPath << std::endl;
+            }
+        }
+
+        std::chrono::high_resolution_clock clock;
+
+        uint64_t tick = 0;
+        uint32_t wavesStarted = 0;
+        uint32_t currentWave = 0;
+        uint32_t numRuns = 0;
+        double physicsTime = 0.0;
+        double updateTime = 0.0;
+        uint64_t sessionChecksum = 0;
+
+        const auto start = clock.now();
+        while (!m_shouldQuit && wavesStarted <= numWaves)
+        {
+            const GameStateMachine &stateMachine = m_game.GetStateMachine();
+            if (stateMachine.HasState<GameStates::PlayingState>())
+            {
+                const uint32_t wave = stateMachine.GetState<GameStates::PlayingState>().wave;
+                if (wave > currentWave)
+                {
+                    // Stop once the wave after the last requested one spawns so that every wave is played through
+                    wavesStarted += wave - currentWave;
+                    currentWave = wave;
+                }
+            }
+            else
+            {
+                // Either still loading or the player died, both start a fresh run
+                m_game.RestartGame();
+                currentWave = 0;
+                numRuns++;
+            }
+
+            UpdateScriptedInput(tick);
+
+            const auto physicsStart = clock.now();
+            m_fixedStepScheduler.Advance(
+                c_fixedUpdateInterval * m_timeScale,
+                [&](float stepDeltaTime, uint32_t numSteps)
+                {
+                    m_physicsWorld.ResetContacts();
+                    FixedUpdate(stepDeltaTime, numSteps);
+                });
+            const auto physicsEnd = clock.now();
+
+            m_deltaTime = c_fixedUpdateInterval;
+            m_timeSinceStart += c_fixedUpdateInterval;
+            m_timeSincePhysics = m_fixedStepScheduler.GetAccumulator();
+
+            const auto updateStart = clock.now();
+            Update(c_fixedUpdateInterval * m_timeScale);
+            // Rendering only submits to the null renderer, but the game relies on it to flush per frame buffers
+            Render();
+            const auto updateEnd = clock.now();
+
+            const uint64_t checksum = m_physicsWorld.ComputeChecksum();
+            sessionChecksum = (sessionChecksum ^ checksum) * 0x100000001b3;
+            if (checksumFile.is_open())
+            {
+                checksumFile << tick << " " << std::hex << checksum << std::dec << "\n";
+            }
+
+            if (tick % memoryLogTicks == 0)
+            {
+                std::cout << m_debugInfo.memory << std::endl;
+                // Only the temp peak is per interval, body and contact peaks cover the whole run for the summary
+                m_physicsWorld.ResetTempAllocatorPeakUsage();
+            }
+
+            physicsTime += std::chrono::duration<double, std::chrono::milliseconds::period>(physicsEnd - physicsStart).count();
+            updateTime += std::chrono::duration<double, std::chrono::milliseconds::period>(updateEnd - updateStart).count();
+            tick++;
+        }
+        const double elapsed = std::chrono::duration<double>(clock.now() - start).count();
+        const MemoryInfo memoryInfo = m_debugInfo.memory;
+        const PhysicsStats physicsStats = m_physicsWorld.GetStats();
+
+        Shutdown();
+
+        std::cout << "Simulated " << glm::min(wavesStarted, numWaves) << " waves over " << numRuns << " runs" << std::endl;
+        std::cout << "Ticks: " << tick << " (" << tick * c_fixedUpdateInterval << " s simulated, " << elapsed << " s wall)" << std::endl;
+        std::cout << "Ticks per second: " << (elapsed > 0.0 ? tick / elapsed : 0.0) << std::endl;
+        std::cout << "Average physics time: " << (tick > 0 ? physicsTime / tick : 0.0) << " ms" << std::endl;
+        std::cout << "Average update time: " << (tick > 0 ? updateTime / tick : 0.0) << " ms" << std::endl;
+        std::cout << memoryInfo << std::endl;
+        std::cout << physicsStats << std::endl;
+        std::cout << "Fixed steps: " << m_fixedStepScheduler.GetStats().totalSteps << " (" << m_fixedStepScheduler.GetStats().totalDroppedTime * 1000.0f << " ms dropped)" << std::endl;
+        std::cout << "Session seed: " << m_random.seed << ", world checksum: " << std::hex << sessionChecksum << std::dec << std::endl;
+
+        return EXIT_SUCCESS;
+    }
+}
@@ -0,0 +1,80 @@
+#include "Audio/AudioSystem.h"
+
+namespace mk
+{
+    // Headless implementation of AudioSystem. Events are only tracked by handle so that game code
+    // behaves the same as with FMOD, nothing is ever played. A stopped event has nothing to fade out
+    // so it is released right away instead of waiting for the next Update.
+
+    bool AudioSystem::Initialize()
+    {
+        return true;
+    }
+
+    void AudioSystem::LoadBank(const std::string &path, BankType type)
+    {
+    }
+
+    void AudioSystem::Update()
+    {
+    }
+
+    void AudioSystem::Shutdown()
+    {
+        m_events.clear();
+    }
+
+    void AudioSystem::PlayEvent(const std::string &eventPath)
+    {
+    }
+
+    EventHandle AudioSystem::CreateEvent(const std::string &eventPath)
+    {
+        m_events[s_eventHandle] = nullptr;
+        return s_eventHandle++;
+    }
+
+    void AudioSystem::PlayEvent(EventHandle event)
+    {
+    }
+
+    void AudioSystem::PlayEventAtPosition(const std::string &eventPath, const glm::vec3 &position, const glm::vec3 &velocity)
+    {
+    }
+
+    void AudioSystem::PlayEventAtPosition(EventHandle event, const glm::vec3 &position, const glm::vec3 &velocity)
+    {
+    }
+
+    void AudioSystem::SetEventPosition(EventHandle event, const glm::vec3 &position, const glm::vec3 &velocity)
+    {
+    }
+
+    void AudioSystem::SetEventParameter(EventHandle event, const std::string &parameter, float value)
+    {
+    }
+
+    void AudioSystem::StopEvent(EventHandle event, bool allowFadeOut)
+    {
+        m_events.erase(event);
+    }
+
+    void AudioSystem::ReleaseEvent(EventHandle event)
+    {
+        m_events.erase(event);
+    }
+
+    void AudioSystem::StopAllEvents(bool allowFadeOut)
+    {
+        m_events.clear();
+    }
+
+    void AudioSystem::ReleaseAllEvents()
+    {
+        m_events.clear();
+    }
+
+    void AudioSystem::SetListenerState(const glm::vec3 &position, const glm::quat &rotation, const glm::vec3 &velocity)
+    {
+    }
+}
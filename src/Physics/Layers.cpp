@@ -9,15 +9,17 @@ namespace mk
         case Layers::NON_MOVING:
             return inObject2 != Layers::NON_MOVING; // Non-moving does not collide with other non-moving
         case Layers::MOVING:
-            return true; // Moving collides with everything
+            return inObject2 != Layers::DEBRIS; // Moving collides with everything but debris
         case Layers::PLAYER:
-            return inObject2 != Layers::PLAYER_PROJECTILE; // Player does not collide with player projectiles
+            return inObject2 != Layers::PLAYER_PROJECTILE && inObject2 != Layers::DEBRIS; // Player does not collide with player projectiles
         case Layers::ENEMY:
-            return inObject2 != Layers::ENEMY_PROJECTILE; // Enemy does not collide with enemy projectiles
+            return inObject2 != Layers::ENEMY_PROJECTILE && inObject2 != Layers::DEBRIS; // Enemy does not collide with enemy projectiles
         case Layers::PLAYER_PROJECTILE:
-            return inObject2 != Layers::PLAYER && inObject2 != Layers::PLAYER_PROJECTILE; // Player projectile does not collide with player or other player projectiles
+            return inObject2 != Layers::PLAYER && inObject2 != Layers::PLAYER_PROJECTILE && inObject2 != Layers::DEBRIS; // Player projectile does not collide with player or other player projectiles
         case Layers::ENEMY_PROJECTILE:
-            return inObject2 != Layers::ENEMY && inObject2 != Layers::ENEMY_PROJECTILE; // Enemy projectile does not collide with enemy or other enemy projectiles
+            return inObject2 != Layers::ENEMY && inObject2 != Layers::ENEMY_PROJECTILE && inObject2 != Layers::DEBRIS; // Enemy projectile does not collide with enemy or other enemy projectiles
+        case Layers::DEBRIS:
+            return inObject2 == Layers::NON_MOVING; // Debris only rests on the level
         default:
             JPH_ASSERT(false);
             return false;
@@ -33,9 +35,13 @@ namespace mk
         case Layers::MOVING:
         case Layers::PLAYER:
         case Layers::ENEMY:
+            return inLayer2 != BroadPhaseLayers::DEBRIS;
         case Layers::PLAYER_PROJECTILE:
+            return inLayer2 != BroadPhaseLayers::PLAYER_PROJECTILE && inLayer2 != BroadPhaseLayers::DEBRIS; // Player projectiles only live next to other player projectiles
         case Layers::ENEMY_PROJECTILE:
-            return true;
+            return inLayer2 != BroadPhaseLayers::ENEMY_PROJECTILE && inLayer2 != BroadPhaseLayers::DEBRIS; // Enemy projectiles only live next to other enemy projectiles
+        case Layers::DEBRIS:
+            return inLayer2 == BroadPhaseLayers::NON_MOVING;
         default:
             JPH_ASSERT(false);
             return false;
@@ -6,13 +6,22 @@
 #include "Jolt/RegisterTypes.h"
 #include "Jolt/Physics/Body/BodyCreationSettings.h"
 #include "Jolt/Physics/Body/BodyActivationListener.h"
+#include "Jolt/Physics/Body/BodyLockMulti.h"
 #include "Jolt/Physics/Collision/CastResult.h"
+#include "Jolt/Physics/Collision/CollideShape.h"
 #include "Jolt/Physics/Collision/CollisionCollectorImpl.h"
 #include "Jolt/Physics/Collision/RayCast.h"
 #include "Jolt/Physics/Collision/Shape/BoxShape.h"
 #include "Jolt/Physics/Collision/Shape/SphereShape.h"
+#include "Jolt/Physics/StateRecorder.h"
 
+#include <algorithm>
 #include <cstdarg>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
 #include <thread>
 
 namespace mk
@@ -20,9 +29,166 @@ namespace mk
 
     using namespace JPH::literals;
 
-    std::unique_ptr<JPH::TempAllocatorImpl> PhysicsWorld::s_tempAllocator;
+    std::unique_ptr<TrackingTempAllocator> PhysicsWorld::s_tempAllocator;
     std::unique_ptr<JPH::JobSystemThreadPool> PhysicsWorld::s_jobSystem;
 
+    class ObjectLayerMaskFilter final : public JPH::ObjectLayerFilter
+    {
+    private:
+        ObjectLayerMask m_mask;
+
+    public:
+        explicit ObjectLayerMaskFilter(ObjectLayerMask mask) : m_mask(mask) {}
+
+        bool ShouldCollide(JPH::ObjectLayer inLayer) const override
+        {
+            return (m_mask >> inLayer) & 1;
+        }
+    };
+
+    // Runs func(begin, end) over [0, count) in chunks on the physics job system, small counts run inline
+    template <typename F>
+    static void ParallelFor(JPH::JobSystem *jobSystem, size_t count, size_t chunkSize, const F &func)
+    {
+        if (count <= chunkSize)
+        {
+            func(size_t(0), count);
+            return;
+        }
+
+        JPH::JobSystem::Barrier *barrier = jobSystem->CreateBarrier();
+        for (size_t begin = 0; begin < count; begin += chunkSize)
+        {
+            const size_t end = std::min(begin + chunkSize, count);
+            JPH::JobHandle job = jobSystem->CreateJob("PhysicsQuery", JPH::Color::sGreen, [&func, begin, end]()
+                                                      { func(begin, end); });
+            barrier->AddJob(job);
+        }
+        jobSystem->WaitForJobs(barrier);
+        jobSystem->DestroyBarrier(barrier);
+    }
+
+    constexpr size_t c_queriesPerJob = 32;
+
+    constexpr uint32_t c_noCommand = std::numeric_limits<uint32_t>::max();
+
+    constexpr size_t c_charactersPerJob = 8;
+    constexpr size_t c_characterTempAllocatorSize = 256 * 1024;
+    constexpr float c_characterCollisionTolerance = 0.05f;
+
+    constexpr size_t c_projectilesPerJob = 128;
+    // Raycast projectiles have no shape, this is only the sphere the debug view draws for them
+    constexpr float c_raycastProjectileDrawRadius = 10.0f;
+
+    // In Jolt units, Jolt's defaults are 0.03 m/s for 0.5 s
+    constexpr float c_debrisSleepVelocity = 0.2f;
+    constexpr float c_debrisTimeBeforeSleep = 0.2f;
+
+    // Auto bodies are swept once they move further than this fraction of their inner radius in a step, which
+    // leaves Jolt's own linear cast threshold some margin. They go back to discrete below the lower fraction.
+    constexpr float c_linearCastFraction = 0.5f;
+    constexpr float c_discreteFraction = 0.25f;
+
+    static JPH::EMotionQuality ToJoltMotionQuality(MotionQuality quality)
+    {
+        // Auto bodies start discrete and are swept by UpdateMotionQuality when they need it
+        return quality == MotionQuality::LinearCast ? JPH::EMotionQuality::LinearCast : JPH::EMotionQuality::Discrete;
+    }
+
+    // Keeps one result per body, Jolt reports all hits of a body right after OnBody while the body is locked.
+    // Bodies that do not fit are still counted, so callers can tell that results were dropped.
+    class OverlapCollector final : public JPH::CollideShapeCollector
+    {
+    private:
+        std::span<OverlapResult> m_results;
+        OverlapResult m_current;
+        bool m_currentAdded = false;
+
+    public:
+        uint32_t numResults = 0;
+        uint32_t numFound = 0;
+
+        explicit OverlapCollector(std::span<OverlapResult> results) : m_results(results) {}
+
+        void OnBody(const JPH::Body &inBody) override
+        {
+            uint64_t userDataBits = inBody.GetUserData();
+            UserData userData = *reinterpret_cast<UserData *>(&userDataBits);
+            m_current = {
+                userData.id,
+                userData.data,
+                static_cast<ObjectLayer>(inBody.GetObjectLayer()),
+                JoltHelpers::ConvertWithUnits(inBody.GetCenterOfMassPosition()),
+            };
+            m_currentAdded = false;
+        }
+
+        void AddHit(const JPH::CollideShapeResult &inResult) override
+        {
+            if (m_currentAdded)
+                return;
+
+            m_currentAdded = true;
+            numFound++;
+            if (numResults < m_results.size())
+            {
+                m_results[numResults++] = m_current;
+            }
+        }
+    };
+
+    // State recorder over a byte vector, so snapshots reuse their buffer instead of going through a string stream
+    class SnapshotRecorder final : public JPH::StateRecorder
+    {
+    private:
+        std::vector<uint8_t> *m_output = nullptr;
+        std::span<const uint8_t> m_input;
+        size_t m_offset = 0;
+        bool m_failed = false;
+
+    public:
+        explicit SnapshotRecorder(std::vector<uint8_t> &output) : m_output(&output) { output.clear(); }
+        explicit SnapshotRecorder(std::span<const uint8_t> input) : m_input(input) {}
+
+        void WriteBytes(const void *inData, size_t inNumBytes) override
+        {
+            assert(m_output != nullptr && "Snapshot recorder is read only");
+            const uint8_t *bytes = static_cast<const uint8_t *>(inData);
+            m_output->insert(m_output->end(), bytes, bytes + inNumBytes);
+        }
+
+        void ReadBytes(void *outData, size_t inNumBytes) override
+        {
+            if (m_offset + inNumBytes > m_input.size())
+            {
+                m_failed = true;
+                return;
+            }
+
+            std::memcpy(outData, m_input.data() + m_offset, inNumBytes);
+            m_offset += inNumBytes;
+        }
+
+        bool IsEOF() const override { return m_offset >= m_input.size(); }
+        bool IsFailed() const override { return m_failed; }
+    };
+
+    static RigidBodyState GetVirtualCharacterState(const JPH::CharacterVirtual &character)
+    {
+        RigidBodyState state;
+        JoltHelpers::StoreWithUnits(JPH::Vec3(character.GetCenterOfMassPosition()), state.position);
+        JoltHelpers::Store(character.GetRotation(), state.rotation);
+        JoltHelpers::StoreWithUnits(character.GetLinearVelocity(), state.linearVelocity);
+        state.angularVelocity = glm::vec3(0.0f);
+        return state;
+    }
+
+    static uint64_t PackUserData(BodyID id, uint32_t data)
+    {
+        UserData userData{id, data};
+        return *reinterpret_cast<uint64_t *>(&userData);
+    }
+
     // Callback for traces, connect this to your own trace function if you have one
     static void TraceImpl(const char *inFMT, ...)
     {
@@ -37,7 +203,83 @@ namespace mk
         std::cout << buffer << std::endl;
     }
 
-    void PhysicsWorld::Initialize()
+    // The temp allocator size is a uint32_t in bytes
+    constexpr long c_maxTempAllocatorMiB = std::numeric_limits<uint32_t>::max() / (1024 * 1024);
+
+    static bool ApplySetting(PhysicsWorldSettings &settings, const std::string &key, const std::string &value)
+    {
+        char *end = nullptr;
+        const long number = std::strtol(value.c_str(), &end, 10);
+        if (end == value.c_str() || *end != '\0')
+            return false;
+
+        // Body ids keep the slot index in the low bits, more bodies than that cannot be addressed
+        if (key == "maxbodies" && number > 0 && number <= static_cast<long>(c_bodyIndexMask))
+            settings.maxBodies = static_cast<uint32_t>(number);
+        else if (key == "maxbodypairs" && number > 0)
+            settings.maxBodyPairs = static_cast<uint32_t>(number);
+        else if (key == "maxcontacts" && number > 0)
+            settings.maxContactConstraints = static_cast<uint32_t>(number);
+        else if (key == "physicstempmb" && number > 0 && number <= c_maxTempAllocatorMiB)
+            settings.tempAllocatorSize = static_cast<uint32_t>(number) * 1024 * 1024;
+        else if (key == "contactsperthread" && number > 0 && number <= std::numeric_limits<uint32_t>::max())
+            settings.contactsPerThread = static_cast<uint32_t>(number);
+        else if (key == "physicsthreads")
+            settings.numThreads = static_cast<int32_t>(number);
+        else if (key == "deterministic")
+            settings.deterministic = number != 0;
+        else
+            return false;
+
+        return true;
+    }
+
+    PhysicsWorldSettings PhysicsWorldSettings::FromCmdArgs(const CmdArgs &cmdArgs)
+    {
+        PhysicsWorldSettings settings;
+
+        const std::string configPath = cmdArgs.GetOptionValue("-physicsconfig");
+        if (!configPath.empty())
+        {
+            std::ifstream file(configPath);
+            if (!file.is_open())
+            {
+                std::cerr << "Failed to open physics config: " << configPath << std::endl;
+            }
+
+            std::string line;
+            while (std::getline(file, line))
+            {
+                std::istringstream stream(line);
+                std::string key, value;
+                if (!(stream >> key) || key[0] == '#')
+                    continue;
+
+                if (!(stream >> value) || !ApplySetting(settings, key, value))
+                {
+                    std::cerr << "Invalid physics config line: " << line << std::endl;
+                }
+            }
+        }
+
+        for (const char *key : {"maxbodies", "maxbodypairs", "maxcontacts", "physicstempmb", "contactsperthread", "physicsthreads"})
+        {
+            const std::string value = cmdArgs.GetOptionValue(std::string("-") + key);
+            if (!value.empty() && !ApplySetting(settings, key, value))
+            {
+                std::cerr << "Invalid value for -" << key << ": " << value << std::endl;
+            }
+        }
+
+        if (cmdArgs.HasFlag("-deterministic"))
+        {
+            settings.deterministic = true;
+        }
+
+        return settings;
+    }
+
+    void PhysicsWorld::Initialize(const PhysicsWorldSettings &settings)
     {
         JPH::RegisterDefaultAllocator();
 
@@ -47,257 +289,1347 @@ namespace mk
 
         JPH::RegisterTypes();
 
-        s_tempAllocator = std::make_unique<JPH::TempAllocatorImpl>(10 * 1024 * 1024);
-        s_jobSystem = std::make_unique<JPH::JobSystemThreadPool>(JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers, -1);
+        m_settings = settings;
+        m_stats = {};
 
-        const uint32_t maxBodies = 1024;
-        const uint32_t numBodyMutexes = 0;
-        const uint32_t maxBodyPairs = 65536;
-        const uint32_t maxContactConstraints = 10240;
+        s_tempAllocator = std::make_unique<TrackingTempAllocator>(settings.tempAllocatorSize);
+        // Workers claim their contact buffer once at start, the thread stepping the world keeps buffer 0
+        s_jobSystem = std::make_unique<JPH::JobSystemThreadPool>();
+        s_jobSystem->SetThreadInitFunction([](int threadIndex)
+                                           { ContactListener::SetThreadIndex(static_cast<uint32_t>(threadIndex) + 1); });
+        s_jobSystem->Init(JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers, settings.numThreads);
 
         m_physicsSystem = std::make_unique<JPH::PhysicsSystem>();
 
-        m_physicsSystem->Init(maxBodies, numBodyMutexes, maxBodyPairs, maxContactConstraints, m_broadPhaseLayerInterface, m_objectVsBroadphaseLayerFilter, m_objectLayerPairFilter);
+        m_physicsSystem->Init(settings.maxBodies, settings.numBodyMutexes, settings.maxBodyPairs, settings.maxContactConstraints, m_broadPhaseLayerInterface, m_objectVsBroadphaseLayerFilter, m_objectLayerPairFilter);
 
         m_physicsSystem->SetBodyActivationListener(&m_bodyActivationListener);
 
-        m_physicsSystem->SetContactListener(&m_contactListener);
+        // Jolt's workers plus the thread calling Update report contacts
+        m_contactListener.Initialize(static_cast<uint32_t>(s_jobSystem->GetMaxConcurrency()), settings.contactsPerThread);
+        m_physicsSystem->SetContactListener(&m_contactListener);
+
+        JPH::PhysicsSettings physicsSettings;
+        physicsSettings.mSpeculativeContactDistance = 0.0f;
+        physicsSettings.mDeterministicSimulation = settings.deterministic;
+
+        m_physicsSystem->SetPhysicsSettings(physicsSettings);
+    }
+
+    void PhysicsWorld::Shutdown()
+    {
+        // Shapes have to be released before the factory and allocators go away
+        m_shapeCache.Clear();
+
+        // Unregisters all types with the factory and cleans up the default material
+        JPH::UnregisterTypes();
+
+        // Destroy the factory
+        delete JPH::Factory::sInstance;
+        JPH::Factory::sInstance = nullptr;
+    }
+
+    static size_t GetCommandKey(BodyID id, BodyCommandType type)
+    {
+        return size_t(GetBodyIndex(id)) * static_cast<size_t>(BodyCommandType::Count) + static_cast<size_t>(type);
+    }
+
+    void PhysicsWorld::QueueCommand(BodyID id, BodyCommandType type, const glm::vec4 &value)
+    {
+        const size_t key = GetCommandKey(id, type);
+        if (key >= m_commandIndices.size())
+        {
+            m_commandIndices.resize(size_t(GetBodyIndex(id) + 1) * static_cast<size_t>(BodyCommandType::Count), c_noCommand);
+        }
+
+        // Game code queues every frame and frames can outnumber steps, e.g. while the debug camera pauses them
+        uint32_t &index = m_commandIndices[key];
+        if (index == c_noCommand)
+        {
+            index = static_cast<uint32_t>(m_commands.size());
+            m_commands.push_back({id, type, value});
+        }
+        else if (type == BodyCommandType::ApplyImpulse && m_commands[index].body == id)
+        {
+            m_commands[index].value += value;
+        }
+        else
+        {
+            // Also replaces a command for a removed body whose slot was reused
+            m_commands[index] = {id, type, value};
+        }
+    }
+
+    void PhysicsWorld::ClearCommands()
+    {
+        for (const BodyCommand &command : m_commands)
+        {
+            m_commandIndices[GetCommandKey(command.body, command.type)] = c_noCommand;
+        }
+        m_commands.clear();
+    }
+
+    void PhysicsWorld::FlushCommands()
+    {
+        if (m_commands.empty())
+            return;
+
+        // Grouping by slot keeps the body accesses in memory order, stable so commands on a body keep their queue order
+        std::stable_sort(m_commands.begin(), m_commands.end(), [](const BodyCommand &a, const BodyCommand &b)
+                         { return GetBodyIndex(a.body) < GetBodyIndex(b.body); });
+
+        JPH::BodyInterface &interface = m_physicsSystem->GetBodyInterfaceNoLock();
+        for (const BodyCommand &command : m_commands)
+        {
+            // Bodies removed after the command was queued are skipped
+            const BodySlot *slot = GetSlot(command.body);
+            if (slot == nullptr)
+                continue;
+
+            if (slot->type == BodyType::RaycastProjectile)
+            {
+                // Raycast projectiles have no mass and do not spin
+                assert((command.type == BodyCommandType::SetLinearVelocity || command.type == BodyCommandType::SetRotation) && "Body command not supported by raycast projectiles");
+                if (command.type == BodyCommandType::SetLinearVelocity)
+                    m_raycastProjectiles.velocities[slot->denseIndex] = glm::vec3(command.value);
+                else if (command.type == BodyCommandType::SetRotation)
+                    m_raycastProjectiles.rotations[slot->denseIndex] = glm::quat(command.value.w, command.value.x, command.value.y, command.value.z);
+                continue;
+            }
+
+            JPH::CharacterVirtual *character = GetVirtualCharacter(*slot);
+            switch (command.type)
+            {
+            case BodyCommandType::SetLinearVelocity:
+                if (character != nullptr)
+                    character->SetLinearVelocity(JoltHelpers::LoadWithUnits(command.value));
+                else
+                    interface.SetLinearVelocity(slot->bodyID, JoltHelpers::LoadWithUnits(command.value));
+                break;
+            case BodyCommandType::SetAngularVelocity:
+                interface.SetAngularVelocity(slot->bodyID, JoltHelpers::Load(command.value));
+                break;
+            case BodyCommandType::SetRotation:
+                if (character != nullptr)
+                    character->SetRotation(JoltHelpers::LoadQuat(command.value));
+                else
+                    interface.SetRotation(slot->bodyID, JoltHelpers::LoadQuat(command.value), JPH::EActivation::Activate);
+                break;
+            case BodyCommandType::ApplyImpulse:
+                interface.AddImpulse(slot->bodyID, JoltHelpers::LoadWithUnits(command.value));
+                break;
+            default:
+                assert(false && "Unknown body command");
+                break;
+            }
+        }
+
+        ClearCommands();
+    }
+
+    void PhysicsWorld::StepSimulation(float dt, uint32_t numSubSteps)
+    {
+        FlushCommands();
+        UpdateMotionQuality(dt / static_cast<float>(std::max(numSubSteps, 1u)));
+        UpdateVirtualCharacters(dt);
+
+        const JPH::EPhysicsUpdateError error = m_physicsSystem->Update(dt, numSubSteps, s_tempAllocator.get(), s_jobSystem.get());
+        UpdateRaycastProjectiles(dt);
+        m_contactListener.MergeContacts();
+
+        // Jolt drops the overflowing pairs and contacts and keeps going, count them so they show up in the stats
+        if ((error & JPH::EPhysicsUpdateError::BodyPairCacheFull) != JPH::EPhysicsUpdateError::None)
+            m_stats.bodyPairOverflows++;
+        if ((error & JPH::EPhysicsUpdateError::ContactConstraintsFull) != JPH::EPhysicsUpdateError::None)
+            m_stats.contactConstraintOverflows++;
+        if ((error & JPH::EPhysicsUpdateError::ManifoldCacheFull) != JPH::EPhysicsUpdateError::None)
+            m_stats.manifoldOverflows++;
+        m_stats.droppedContacts += m_contactListener.GetNumDropped();
+
+        m_stats.numContacts = m_contactListener.GetNumManifolds();
+        m_stats.peakContacts = std::max(m_stats.peakContacts, m_stats.numContacts);
+        m_stats.numBodies = m_physicsSystem->GetNumBodies();
+        m_stats.peakBodies = std::max(m_stats.peakBodies, m_stats.numBodies);
+
+        UpdateDebris(dt);
+        PostSimulateCharacters();
+    }
+
+    void PhysicsWorld::UpdateVirtualCharacters(float dt)
+    {
+        if (m_virtualCharacters.empty())
+            return;
+
+        const size_t numJobs = (m_virtualCharacters.size() + c_charactersPerJob - 1) / c_charactersPerJob;
+        while (m_characterAllocators.size() < numJobs)
+        {
+            m_characterAllocators.push_back(std::make_unique<JPH::TempAllocatorImpl>(c_characterTempAllocatorSize));
+        }
+
+        // Characters push each other through their inner bodies, so in deterministic mode they are updated in order
+        const size_t charactersPerJob = m_settings.deterministic ? m_virtualCharacters.size() : c_charactersPerJob;
+        const JPH::Vec3 gravity = m_physicsSystem->GetGravity();
+        ParallelFor(s_jobSystem.get(), m_virtualCharacters.size(), charactersPerJob, [&](size_t begin, size_t end)
+                    {
+                        JPH::TempAllocator &allocator = *m_characterAllocators[begin / charactersPerJob];
+                        for (size_t i = begin; i < end; i++)
+                        {
+                            const VirtualCharacter &entry = m_virtualCharacters[i];
+                            JPH::CharacterVirtual &character = *entry.character;
+                            const JPH::Vec3 characterGravity = gravity * entry.gravityFactor;
+
+                            // Kinematic, so gravity is applied here unless the character rests on the ground
+                            JPH::Vec3 velocity = character.GetLinearVelocity();
+                            const JPH::Vec3 groundVelocity = character.GetGroundVelocity();
+                            if (character.GetGroundState() == JPH::CharacterBase::EGroundState::OnGround && velocity.GetY() <= groundVelocity.GetY())
+                            {
+                                velocity.SetY(groundVelocity.GetY());
+                            }
+                            else
+                            {
+                                velocity += characterGravity * dt;
+                            }
+                            character.SetLinearVelocity(velocity);
+
+                            const JPH::ObjectLayer layer = static_cast<JPH::ObjectLayer>(m_slots[entry.slot].layer);
+                            character.Update(dt, characterGravity,
+                                             m_physicsSystem->GetDefaultBroadPhaseLayerFilter(layer),
+                                             m_physicsSystem->GetDefaultLayerFilter(layer),
+                                             JPH::IgnoreSingleBodyFilter(character.GetInnerBodyID()),
+                                             JPH::ShapeFilter(),
+                                             allocator);
+                        } });
+    }
+
+    void PhysicsWorld::PostSimulateCharacters()
+    {
+        ParallelFor(s_jobSystem.get(), m_characters.size(), c_charactersPerJob, [&](size_t begin, size_t end)
+                    {
+                        for (size_t i = begin; i < end; i++)
+                        {
+                            m_slots[m_characters[i]].character->PostSimulation(c_characterCollisionTolerance);
+                        } });
+    }
+
+    void PhysicsWorld::RemoveCharacter(BodySlot &slot)
+    {
+        if (slot.type == BodyType::VirtualCharacter)
+        {
+            // Releasing the character also removes and destroys its inner body
+            VirtualCharacter &removed = m_virtualCharacters[slot.denseIndex];
+            removed = std::move(m_virtualCharacters.back());
+            m_slots[removed.slot].denseIndex = slot.denseIndex;
+            m_virtualCharacters.pop_back();
+        }
+        else
+        {
+            slot.character->RemoveFromPhysicsSystem();
+            slot.character.reset();
+
+            const uint32_t last = m_characters.back();
+            m_characters[slot.denseIndex] = last;
+            m_slots[last].denseIndex = slot.denseIndex;
+            m_characters.pop_back();
+        }
+    }
+
+    void PhysicsWorld::UpdateRaycastProjectiles(float dt)
+    {
+        RaycastProjectiles &projectiles = m_raycastProjectiles;
+        if (projectiles.ids.empty())
+            return;
+
+        // Swept against the world at the end of the step, so hits are merged together with the body contacts
+        const glm::vec3 gravity = JoltHelpers::ConvertWithUnits(m_physicsSystem->GetGravity());
+        const JPH::NarrowPhaseQuery &query = m_physicsSystem->GetNarrowPhaseQueryNoLock();
+        const JPH::BodyLockInterfaceNoLock &lockInterface = m_physicsSystem->GetBodyLockInterfaceNoLock();
+
+        ParallelFor(s_jobSystem.get(), projectiles.ids.size(), c_projectilesPerJob, [&](size_t begin, size_t end)
+                    {
+                        for (size_t i = begin; i < end; i++)
+                        {
+                            // Integrated analytically, so the arc does not depend on the step size
+                            glm::vec3 &velocity = projectiles.velocities[i];
+                            const glm::vec3 acceleration = gravity * projectiles.gravityFactors[i];
+                            const glm::vec3 from = projectiles.positions[i];
+                            const glm::vec3 delta = velocity * dt + 0.5f * acceleration * dt * dt;
+                            velocity += acceleration * dt;
+                            if (delta == glm::vec3(0.0f))
+                                continue;
+
+                            const BodyID id = projectiles.ids[i];
+                            const BodySlot &slot = m_slots[GetBodyIndex(id)];
+                            const JPH::ObjectLayer layer = static_cast<JPH::ObjectLayer>(slot.layer);
+
+                            JPH::RRayCast ray;
+                            ray.mOrigin = JoltHelpers::ConvertWithUnits(from);
+                            ray.mDirection = JoltHelpers::ConvertWithUnits(delta);
+
+                            JPH::RayCastResult hit;
+                            if (!query.CastRay(ray, hit, m_physicsSystem->GetDefaultBroadPhaseLayerFilter(layer), m_physicsSystem->GetDefaultLayerFilter(layer)))
+                            {
+                                projectiles.positions[i] = from + delta;
+                                continue;
+                            }
+
+                            JPH::BodyLockRead lock(lockInterface, hit.mBodyID);
+                            if (!lock.Succeeded())
+                            {
+                                projectiles.positions[i] = from + delta;
+                                continue;
+                            }
+
+                            const JPH::Body &body = lock.GetBody();
+                            const JPH::RVec3 point = ray.GetPointOnRay(hit.mFraction);
+                            const glm::vec3 position = JoltHelpers::ConvertWithUnits(JPH::Vec3(point));
+                            const glm::vec3 normal = JoltHelpers::Convert(body.GetWorldSpaceSurfaceNormal(hit.mSubShapeID2, point));
+                            uint64_t userDataBits = body.GetUserData();
+                            const UserData userData = *reinterpret_cast<UserData *>(&userDataBits);
+
+                            // Stops at the hit until the game removes it, like a body would after an impact
+                            projectiles.positions[i] = position;
+                            velocity = glm::vec3(0.0f);
+                            projectiles.gravityFactors[i] = 0.0f;
+
+                            // Same convention as Jolt contacts, the normal points from the owner towards the other body
+                            m_contactListener.AddContact(id, Contact{userData.id, userData.data, static_cast<ObjectLayer>(body.GetObjectLayer()), position, -normal, 0.0f});
+                            m_contactListener.AddContact(userData.id, Contact{id, slot.data, slot.layer, position, normal, 0.0f});
+                        } });
+    }
+
+    void PhysicsWorld::RemoveRaycastProjectile(BodySlot &slot)
+    {
+        RaycastProjectiles &projectiles = m_raycastProjectiles;
+        const uint32_t index = slot.denseIndex;
+        const size_t last = projectiles.ids.size() - 1;
+
+        m_slots[GetBodyIndex(projectiles.ids[last])].denseIndex = index;
+        projectiles.ids[index] = projectiles.ids[last];
+        projectiles.positions[index] = projectiles.positions[last];
+        projectiles.velocities[index] = projectiles.velocities[last];
+        projectiles.rotations[index] = projectiles.rotations[last];
+        projectiles.gravityFactors[index] = projectiles.gravityFactors[last];
+
+        projectiles.ids.pop_back();
+        projectiles.positions.pop_back();
+        projectiles.velocities.pop_back();
+        projectiles.rotations.pop_back();
+        projectiles.gravityFactors.pop_back();
+    }
+
+    RigidBodyState PhysicsWorld::GetRaycastProjectileState(const BodySlot &slot) const
+    {
+        const uint32_t index = slot.denseIndex;
+        return {m_raycastProjectiles.positions[index], m_raycastProjectiles.rotations[index], m_raycastProjectiles.velocities[index], glm::vec3(0.0f)};
+    }
+
+    BodyID PhysicsWorld::CreateRaycastProjectile(ObjectLayer layer, const glm::vec3 &position, const glm::quat &rotation, const glm::vec3 &velocity, float gravityFactor, uint32_t data)
+    {
+        assert(layer != ObjectLayer::None && "Raycast projectiles need an explicit layer");
+
+        const uint32_t index = AllocateSlot();
+        BodySlot &slot = m_slots[index];
+        slot.alive = true;
+        slot.type = BodyType::RaycastProjectile;
+        slot.layer = layer;
+        slot.data = data;
+        slot.collision = {SphereShape(c_raycastProjectileDrawRadius), layer};
+        slot.denseIndex = static_cast<uint32_t>(m_raycastProjectiles.ids.size());
+
+        const BodyID id = MakeBodyID(index, slot.generation);
+        m_raycastProjectiles.ids.push_back(id);
+        m_raycastProjectiles.positions.push_back(position);
+        m_raycastProjectiles.velocities.push_back(velocity);
+        m_raycastProjectiles.rotations.push_back(rotation);
+        m_raycastProjectiles.gravityFactors.push_back(gravityFactor);
+
+        return id;
+    }
+
+    void PhysicsWorld::TrackMotionQuality(BodyID id, const BodySlot &slot)
+    {
+        // A pooled body may still be swept from its previous use
+        JPH::BodyInterface &interface = m_physicsSystem->GetBodyInterfaceNoLock();
+        interface.SetMotionQuality(slot.bodyID, JPH::EMotionQuality::Discrete);
+        m_autoMotionQuality.push_back({id, slot.shape->GetInnerRadius() * c_linearCastFraction, false});
+    }
+
+    void PhysicsWorld::UpdateMotionQuality(float dt)
+    {
+        JPH::BodyInterface &interface = m_physicsSystem->GetBodyInterfaceNoLock();
+        for (size_t i = 0; i < m_autoMotionQuality.size();)
+        {
+            AutoMotionQualityBody &body = m_autoMotionQuality[i];
+            const BodySlot *slot = GetSlot(body.id);
+            if (slot == nullptr || slot->motionQuality != MotionQuality::Auto)
+            {
+                // Removed, released back to its pool or turned into debris
+                body = m_autoMotionQuality.back();
+                m_autoMotionQuality.pop_back();
+                continue;
+            }
+
+            i++;
+
+            // Swept bodies need to slow down further before they switch back, so they do not flip every step
+            const float castDistance = body.linearCast ? body.castDistance * (c_discreteFraction / c_linearCastFraction) : body.castDistance;
+            const float distanceSq = interface.GetLinearVelocity(slot->bodyID).LengthSq() * dt * dt;
+            const bool linearCast = distanceSq > castDistance * castDistance;
+            if (linearCast != body.linearCast)
+            {
+                interface.SetMotionQuality(slot->bodyID, linearCast ? JPH::EMotionQuality::LinearCast : JPH::EMotionQuality::Discrete);
+                body.linearCast = linearCast;
+            }
+        }
+    }
+
+    void PhysicsWorld::UpdateDebris(float dt)
+    {
+        JPH::BodyInterface &interface = m_physicsSystem->GetBodyInterfaceNoLock();
+        for (size_t i = 0; i < m_debris.size();)
+        {
+            DebrisBody &debris = m_debris[i];
+            const BodySlot *slot = GetSlot(debris.id);
+            if (slot == nullptr || slot->layer != ObjectLayer::Debris)
+            {
+                // Removed, or put back on another layer by a snapshot restore
+                debris = m_debris.back();
+                m_debris.pop_back();
+                continue;
+            }
+
+            i++;
+            if (!interface.IsActive(slot->bodyID))
+                continue;
+
+            const float sleepVelocitySq = c_debrisSleepVelocity * c_debrisSleepVelocity;
+            JPH::Vec3 linearVelocity, angularVelocity;
+            interface.GetLinearAndAngularVelocity(slot->bodyID, linearVelocity, angularVelocity);
+            if (linearVelocity.LengthSq() > sleepVelocitySq || angularVelocity.LengthSq() > sleepVelocitySq)
+            {
+                debris.restTime = 0.0f;
+                continue;
+            }
+
+            debris.restTime += dt;
+            if (debris.restTime >= c_debrisTimeBeforeSleep)
+            {
+                // Only the level can touch debris, so nothing wakes it up again
+                interface.DeactivateBody(slot->bodyID);
+            }
+        }
+    }
+
+    RigidBodyState PhysicsWorld::GetRigidBodyState(BodyID id)
+    {
+        const BodySlot *slot = GetSlot(id);
+        if (slot == nullptr)
+            return {glm::vec3(0.0f), glm::identity<glm::quat>(), glm::vec3(0.0f), glm::vec3(0.0f)};
+
+        if (const JPH::CharacterVirtual *character = GetVirtualCharacter(*slot))
+            return GetVirtualCharacterState(*character);
+        if (slot->type == BodyType::RaycastProjectile)
+            return GetRaycastProjectileState(*slot);
+
+        JPH::BodyInterface &interface = m_physicsSystem->GetBodyInterfaceNoLock();
+        JPH::BodyID bodyId = slot->bodyID;
+
+        JPH::Vec3 position = interface.GetCenterOfMassPosition(bodyId);
+        JPH::Quat rotation = interface.GetRotation(bodyId);
+        JPH::Vec3 linearVelocity = interface.GetLinearVelocity(bodyId);
+        JPH::Vec3 angularVelocity = interface.GetAngularVelocity(bodyId);
+
+        return {
+            JoltHelpers::ConvertWithUnits(position),
+            JoltHelpers::Convert(rotation),
+            JoltHelpers::ConvertWithUnits(linearVelocity),
+            JoltHelpers::Convert(angularVelocity)};
+    }
+
+    void PhysicsWorld::GetRigidBodyStates(std::span<const BodyID> ids, std::span<RigidBodyState> outStates)
+    {
+        assert(outStates.size() >= ids.size() && "Output span too small");
+
+        // Resolve the slots first so the lock is taken once over a flat array of Jolt IDs
+        std::vector<JPH::BodyID> &bodyIds = m_readbackBodyIDs;
+        bodyIds.resize(ids.size());
+        for (size_t i = 0; i < ids.size(); i++)
+        {
+            const BodySlot *slot = GetSlot(ids[i]);
+            bodyIds[i] = slot != nullptr ? slot->bodyID : JPH::BodyID();
+        }
+
+        m_readbackPositions.resize(ids.size());
+        m_readbackRotations.resize(ids.size());
+        m_readbackLinearVelocities.resize(ids.size());
+        m_readbackAngularVelocities.resize(ids.size());
+        {
+            JPH::BodyLockMultiRead lock(m_physicsSystem->GetBodyLockInterface(), bodyIds.data(), static_cast<int>(bodyIds.size()));
+            for (size_t i = 0; i < bodyIds.size(); i++)
+            {
+                const JPH::Body *body = bodyIds[i].IsInvalid() ? nullptr : lock.GetBody(static_cast<int>(i));
+                if (body == nullptr)
+                {
+                    m_readbackPositions[i] = JPH::Vec3::sZero();
+                    m_readbackRotations[i] = JPH::Quat::sIdentity();
+                    m_readbackLinearVelocities[i] = JPH::Vec3::sZero();
+                    m_readbackAngularVelocities[i] = JPH::Vec3::sZero();
+                    continue;
+                }
+
+                m_readbackPositions[i] = JPH::Vec3(body->GetCenterOfMassPosition());
+                m_readbackRotations[i] = body->GetRotation();
+                m_readbackLinearVelocities[i] = body->GetLinearVelocity();
+                m_readbackAngularVelocities[i] = body->GetAngularVelocity();
+            }
+        }
+
+        JoltHelpers::StoreWithUnits<RigidBodyState>(m_readbackPositions, outStates, &RigidBodyState::position);
+        JoltHelpers::Store<RigidBodyState>(m_readbackRotations, outStates, &RigidBodyState::rotation);
+        JoltHelpers::StoreWithUnits<RigidBodyState>(m_readbackLinearVelocities, outStates, &RigidBodyState::linearVelocity);
+        JoltHelpers::Store<RigidBodyState>(m_readbackAngularVelocities, outStates, &RigidBodyState::angularVelocity);
+
+        // The inner body of a virtual character is moved kinematically and lags a step behind the character,
+        // raycast projectiles have no body at all
+        if (m_virtualCharacters.empty() && m_raycastProjectiles.ids.empty())
+            return;
+
+        for (size_t i = 0; i < ids.size(); i++)
+        {
+            const BodySlot *slot = GetSlot(ids[i]);
+            if (slot == nullptr)
+                continue;
+
+            if (const JPH::CharacterVirtual *character = GetVirtualCharacter(*slot))
+            {
+                outStates[i] = GetVirtualCharacterState(*character);
+            }
+            else if (slot->type == BodyType::RaycastProjectile)
+            {
+                outStates[i] = GetRaycastProjectileState(*slot);
+            }
+        }
+    }
+
+    glm::vec3 PhysicsWorld::GetPosition(BodyID id)
+    {
+        const BodySlot *slot = GetSlot(id);
+        if (slot == nullptr)
+            return glm::vec3(0.0f);
+
+        if (const JPH::CharacterVirtual *character = GetVirtualCharacter(*slot))
+            return JoltHelpers::ConvertWithUnits(JPH::Vec3(character->GetCenterOfMassPosition()));
+        if (slot->type == BodyType::RaycastProjectile)
+            return m_raycastProjectiles.positions[slot->denseIndex];
+
+        JPH::BodyInterface &interface = m_physicsSystem->GetBodyInterfaceNoLock();
+        JPH::Vec3 position = interface.GetCenterOfMassPosition(slot->bodyID);
+        return JoltHelpers::ConvertWithUnits(position);
+    }
+
+    glm::vec3 PhysicsWorld::GetLinearVelocity(BodyID id)
+    {
+        const BodySlot *slot = GetSlot(id);
+        if (slot == nullptr)
+            return glm::vec3(0.0f);
+
+        if (const JPH::CharacterVirtual *character = GetVirtualCharacter(*slot))
+            return JoltHelpers::ConvertWithUnits(character->GetLinearVelocity());
+        if (slot->type == BodyType::RaycastProjectile)
+            return m_raycastProjectiles.velocities[slot->denseIndex];
+
+        JPH::BodyInterface &interface = m_physicsSystem->GetBodyInterfaceNoLock();
+        JPH::Vec3 linearVelocity = interface.GetLinearVelocity(slot->bodyID);
+        return JoltHelpers::ConvertWithUnits(linearVelocity);
+    }
+
+    bool PhysicsWorld::IsBodyActive(BodyID id) const
+    {
+        const BodySlot *slot = GetSlot(id);
+        if (slot == nullptr)
+            return false;
+
+        // Virtual characters are moved every step whether their inner body sleeps or not, raycast projectiles never sleep
+        return slot->type == BodyType::VirtualCharacter || slot->type == BodyType::RaycastProjectile || m_physicsSystem->GetBodyInterfaceNoLock().IsActive(slot->bodyID);
+    }
+
+    ObjectLayer PhysicsWorld::GetObjectLayer(BodyID id) const
+    {
+        const BodySlot *slot = GetSlot(id);
+        return slot != nullptr ? slot->layer : ObjectLayer::None;
+    }
+
+    BodyID PhysicsWorld::CreateRigidBody(const RigidBodySettings &info, BodyType type)
+    {
+        const uint32_t index = AllocateSlot();
+        BodySlot &slot = m_slots[index];
+        const BodyID id = MakeBodyID(index, slot.generation);
+        JPH::BodyInterface &interface = m_physicsSystem->GetBodyInterfaceNoLock();
+
+        static_assert(sizeof(UserData) == sizeof(JPH::uint64), "UserData must be 64 bits");
+        UserData userData{id, info.data};
+        uint64_t userDataBits = *reinterpret_cast<uint64_t *>(&userData); // :) I know
+
+        // Creating shape
+        JPH::ShapeSettings::ShapeResult shapeResult = std::visit(
+            [&](const auto &shape)
+            { return shape.GetShapeSettings(); },
+            info.shape);
+        JPH::ShapeRefC shape = shapeResult.Get();
+
+        slot.alive = true;
+        slot.type = type;
+        slot.data = info.data;
+        slot.shape = shape;
+        slot.collision = {info.shape, info.layer};
+
+        if (type == BodyType::Rigidbody)
+        {
+            JPH::ObjectLayer layer = info.layer != ObjectLayer::None ? static_cast<JPH::ObjectLayer>(info.layer) : info.mass > 0.0f ? Layers::MOVING
+                                                                                                                                    : Layers::NON_MOVING;
+            JPH::EMotionType motionType = info.mass > 0.0f ? JPH::EMotionType::Dynamic : JPH::EMotionType::Static;
+
+            JPH::BodyCreationSettings settings(shape, JoltHelpers::ConvertWithUnits(info.position), JoltHelpers::Convert(info.rotation), motionType, layer);
+            settings.mGravityFactor = info.gravityFactor;
+            settings.mMotionQuality = ToJoltMotionQuality(info.motionQuality);
+            settings.mUserData = userDataBits;
+            settings.mIsSensor = info.isSensor;
+            JPH::BodyID bodyId = interface.CreateAndAddBody(settings, JPH::EActivation::Activate);
+            if (bodyId.IsInvalid())
+            {
+                std::cerr << "Failed to create rigid body, out of bodies (max " << m_settings.maxBodies << ")" << std::endl;
+                slot = {};
+                slot.generation = static_cast<uint16_t>(GetBodyGeneration(id));
+                ReleaseSlot(index);
+                return c_invalidBodyID;
+            }
+            interface.SetLinearVelocity(bodyId, JoltHelpers::ConvertWithUnits(info.initialVelocity));
+            slot.bodyID = bodyId;
+            slot.settings = std::make_shared<const JPH::BodyCreationSettings>(settings);
+            slot.layer = static_cast<ObjectLayer>(layer);
+
+            if (motionType == JPH::EMotionType::Dynamic && info.motionQuality == MotionQuality::Auto)
+            {
+                slot.motionQuality = MotionQuality::Auto;
+                TrackMotionQuality(id, slot);
+            }
+        }
+        else if (type == BodyType::Character)
+        {
+            JPH::CharacterSettings settings;
+            settings.mShape = shape;
+            settings.mLayer = info.layer != ObjectLayer::None ? static_cast<JPH::ObjectLayer>(info.layer) : Layers::MOVING;
+            settings.mUp = JPH::Vec3::sAxisY();
+            settings.mGravityFactor = info.gravityFactor;
+            settings.mSupportingVolume = JPH::Plane(JPH::Vec3::sAxisY(), -shape->GetLocalBounds().GetExtent().GetY());
+            settings.mFriction = info.friction;
+            // Hardcoded for now
+            settings.mMaxSlopeAngle = glm::radians(45.0f);
+
+            std::unique_ptr<JPH::Character> character = std::make_unique<JPH::Character>(&settings, JoltHelpers::ConvertWithUnits(info.position), JoltHelpers::Convert(info.rotation), 0, m_physicsSystem.get());
+            character->AddToPhysicsSystem(JPH::EActivation::Activate);
+            JPH::BodyID bodyId = character->GetBodyID();
+            slot.character = std::move(character);
+            slot.bodyID = bodyId;
+            slot.layer = static_cast<ObjectLayer>(settings.mLayer);
+            interface.SetUserData(bodyId, userDataBits);
+            slot.denseIndex = static_cast<uint32_t>(m_characters.size());
+            m_characters.push_back(index);
+        }
+        else if (type == BodyType::VirtualCharacter)
+        {
+            JPH::Ref<JPH::CharacterVirtualSettings> settings = new JPH::CharacterVirtualSettings();
+            settings->mShape = shape;
+            settings->mUp = JPH::Vec3::sAxisY();
+            settings->mSupportingVolume = JPH::Plane(JPH::Vec3::sAxisY(), -shape->GetLocalBounds().GetExtent().GetY());
+            // Hardcoded for now, same as the rigid body character
+            settings->mMaxSlopeAngle = glm::radians(45.0f);
+            // The inner body is what projectiles, contacts and queries hit
+            settings->mInnerBodyShape = shape;
+            settings->mInnerBodyLayer = info.layer != ObjectLayer::None ? static_cast<JPH::ObjectLayer>(info.layer) : Layers::MOVING;
+
+            JPH::Ref<JPH::CharacterVirtual> character = new JPH::CharacterVirtual(settings, JoltHelpers::ConvertWithUnits(info.position), JoltHelpers::Convert(info.rotation), userDataBits, m_physicsSystem.get());
+            character->SetLinearVelocity(JoltHelpers::ConvertWithUnits(info.initialVelocity));
+            slot.bodyID = character->GetInnerBodyID();
+            slot.layer = static_cast<ObjectLayer>(settings->mInnerBodyLayer);
+            interface.SetUserData(slot.bodyID, userDataBits);
+            slot.denseIndex = static_cast<uint32_t>(m_virtualCharacters.size());
+            m_virtualCharacters.push_back({character, index, info.gravityFactor});
+        }
+        else
+        {
+            assert(false && "Unknown body type");
+        }
+
+        return id;
+    }
+
+    PhysicsStats PhysicsWorld::GetStats() const
+    {
+        PhysicsStats stats = m_stats;
+        stats.maxBodies = m_settings.maxBodies;
+        stats.maxContactConstraints = m_settings.maxContactConstraints;
+        stats.peakTempBytes = GetTempAllocatorPeakUsage();
+        stats.tempAllocatorSize = GetTempAllocatorSize();
+        return stats;
+    }
+
+    uint64_t PhysicsWorld::ComputeChecksum() const
+    {
+        // FNV-1a, the raw float bits are hashed so any divergence shows up
+        uint64_t hash = 0xcbf29ce484222325;
+        const auto combine = [&](const void *data, size_t size)
+        {
+            const uint8_t *bytes = static_cast<const uint8_t *>(data);
+            for (size_t i = 0; i < size; i++)
+            {
+                hash ^= bytes[i];
+                hash *= 0x100000001b3;
+            }
+        };
+
+        const JPH::BodyInterface &interface = m_physicsSystem->GetBodyInterfaceNoLock();
+        for (uint32_t i = 0; i < m_slots.size(); i++)
+        {
+            const BodySlot &slot = m_slots[i];
+            if (!slot.alive)
+                continue;
+
+            const BodyID id = MakeBodyID(i, slot.generation);
+            RigidBodyState state;
+            if (slot.type == BodyType::RaycastProjectile)
+            {
+                state = GetRaycastProjectileState(slot);
+            }
+            else if (const JPH::CharacterVirtual *character = GetVirtualCharacter(slot))
+            {
+                state = GetVirtualCharacterState(*character);
+            }
+            else
+            {
+                state = {
+                    JoltHelpers::Convert(JPH::Vec3(interface.GetCenterOfMassPosition(slot.bodyID))),
+                    JoltHelpers::Convert(interface.GetRotation(slot.bodyID)),
+                    JoltHelpers::Convert(interface.GetLinearVelocity(slot.bodyID)),
+                    JoltHelpers::Convert(interface.GetAngularVelocity(slot.bodyID))};
+            }
+
+            combine(&id, sizeof(id));
+            combine(&state, sizeof(state));
+        }
+
+        return hash;
+    }
+
+    void PhysicsWorld::ResetStats()
+    {
+        m_stats.peakBodies = m_stats.numBodies;
+        m_stats.peakContacts = m_stats.numContacts;
+        m_stats.bodyPairOverflows = 0;
+        m_stats.contactConstraintOverflows = 0;
+        m_stats.manifoldOverflows = 0;
+        m_stats.droppedContacts = 0;
+        ResetTempAllocatorPeakUsage();
+    }
+
+    uint32_t PhysicsWorld::AllocateSlot()
+    {
+        if (!m_freeSlots.empty())
+        {
+            const uint32_t index = m_freeSlots.back();
+            m_freeSlots.pop_back();
+            return index;
+        }
+
+        assert(m_slots.size() < c_bodyIndexMask && "BodyID overflow");
+        m_slots.emplace_back();
+        return static_cast<uint32_t>(m_slots.size() - 1);
+    }
+
+    void PhysicsWorld::ReleaseSlot(uint32_t index)
+    {
+        // Retire the slot once the generation runs out so the handle can never become c_invalidBodyID
+        if (++m_slots[index].generation < c_maxBodyGeneration)
+        {
+            m_freeSlots.push_back(index);
+        }
+    }
+
+    void PhysicsWorld::CreatePooledBody(ProjectilePoolID poolID)
+    {
+        ProjectilePool &pool = m_projectilePools[poolID];
+        JPH::BodyInterface &interface = m_physicsSystem->GetBodyInterfaceNoLock();
+
+        if (pool.bodySettings == nullptr)
+        {
+            JPH::BodyCreationSettings settings(pool.shape, JPH::RVec3::sZero(), JPH::Quat::sIdentity(), JPH::EMotionType::Dynamic, static_cast<JPH::ObjectLayer>(pool.settings.layer));
+            settings.mMotionQuality = ToJoltMotionQuality(pool.settings.motionQuality);
+            settings.mIsSensor = pool.settings.isSensor;
+            pool.bodySettings = std::make_shared<const JPH::BodyCreationSettings>(settings);
+        }
+
+        JPH::Body *body = interface.CreateBody(*pool.bodySettings);
+        if (body == nullptr)
+        {
+            std::cerr << "Failed to create pooled projectile body, out of bodies" << std::endl;
+            return;
+        }
+
+        // The slot is owned by the pool for the lifetime of the world, it is never returned to m_freeSlots
+        const uint32_t index = AllocateSlot();
+        BodySlot &slot = m_slots[index];
+        slot.bodyID = body->GetID();
+        slot.layer = pool.settings.layer;
+        slot.type = BodyType::Rigidbody;
+        slot.shape = pool.shape;
+        slot.collision = {SphereShape(pool.settings.radius), pool.settings.layer};
+        slot.pool = poolID;
+        slot.motionQuality = pool.settings.motionQuality;
+        slot.settings = pool.bodySettings;
+        pool.freeSlots.push_back(index);
+    }
+
+    ProjectilePoolID PhysicsWorld::GetProjectilePool(const ProjectilePoolSettings &settings)
+    {
+        for (ProjectilePoolID i = 0; i < m_projectilePools.size(); i++)
+        {
+            if (m_projectilePools[i].settings == settings)
+                return i;
+        }
+
+        assert(settings.layer != ObjectLayer::None && "Projectile pools need an explicit layer");
+
+        const ProjectilePoolID poolID = static_cast<ProjectilePoolID>(m_projectilePools.size());
+        m_projectilePools.push_back({settings, SphereShape(settings.radius).GetShapeSettings().Get(), {}});
+        m_projectilePools.back().freeSlots.reserve(settings.capacity);
+        for (uint32_t i = 0; i < settings.capacity; i++)
+        {
+            CreatePooledBody(poolID);
+        }
+
+        return poolID;
+    }
+
+    BodyID PhysicsWorld::AcquireProjectileBody(ProjectilePoolID poolID, const glm::vec3 &position, const glm::quat &rotation, const glm::vec3 &velocity, float gravityFactor, uint32_t data)
+    {
+        assert(poolID < m_projectilePools.size() && "Invalid projectile pool");
+
+        ProjectilePool &pool = m_projectilePools[poolID];
+        if (pool.freeSlots.empty())
+        {
+            // Grow on demand, the capacity is only a warm start
+            CreatePooledBody(poolID);
+            if (pool.freeSlots.empty())
+                return c_invalidBodyID;
+        }
+
+        const uint32_t index = pool.freeSlots.back();
+        pool.freeSlots.pop_back();
+
+        BodySlot &slot = m_slots[index];
+        slot.alive = true;
+        slot.data = data;
+        const BodyID id = MakeBodyID(index, slot.generation);
+
+        UserData userData{id, data};
+        uint64_t userDataBits = *reinterpret_cast<uint64_t *>(&userData);
+
+        JPH::BodyInterface &interface = m_physicsSystem->GetBodyInterfaceNoLock();
+        interface.SetPositionAndRotation(slot.bodyID, JoltHelpers::ConvertWithUnits(position), JoltHelpers::Convert(rotation), JPH::EActivation::DontActivate);
+        interface.SetLinearAndAngularVelocity(slot.bodyID, JoltHelpers::ConvertWithUnits(velocity), JPH::Vec3::sZero());
+        interface.SetGravityFactor(slot.bodyID, gravityFactor);
+        interface.SetUserData(slot.bodyID, userDataBits);
+        if (pool.settings.motionQuality == MotionQuality::Auto)
+        {
+            TrackMotionQuality(id, slot);
+        }
+        interface.AddBody(slot.bodyID, JPH::EActivation::Activate);
+
+        return id;
+    }
+
+    void PhysicsWorld::ReleaseProjectileBody(BodyID id)
+    {
+        BodySlot *slot = GetSlot(id);
+        if (slot == nullptr || slot->pool == c_invalidProjectilePoolID)
+            return;
+
+        // The listening bit is per slot, so it has to be cleared before the slot is handed out again
+        m_contactListener.Unregister(id);
+
+        JPH::BodyInterface &interface = m_physicsSystem->GetBodyInterfaceNoLock();
+        if (interface.IsAdded(slot->bodyID))
+        {
+            interface.RemoveBody(slot->bodyID);
+        }
+
+        // Bump the generation so contacts and commands holding the old handle no longer resolve
+        slot->alive = false;
+        if (++slot->generation < c_maxBodyGeneration)
+        {
+            m_projectilePools[slot->pool].freeSlots.push_back(GetBodyIndex(id));
+        }
+        else
+        {
+            // Retired, the pool creates a replacement on demand
+            interface.DestroyBody(slot->bodyID);
+            slot->bodyID = JPH::BodyID();
+            slot->shape = nullptr;
+            slot->settings = nullptr;
+        }
+    }
+
+    void PhysicsWorld::RemoveRigidBody(BodyID id)
+    {
+        BodySlot *slot = GetSlot(id);
+        if (slot == nullptr)
+            return;
+
+        if (slot->pool != c_invalidProjectilePoolID)
+        {
+            ReleaseProjectileBody(id);
+            return;
+        }
+
+        m_contactListener.Unregister(id);
+
+        if (slot->type == BodyType::RaycastProjectile)
+        {
+            RemoveRaycastProjectile(*slot);
+        }
+        else if (slot->type != BodyType::Rigidbody)
+        {
+            RemoveCharacter(*slot);
+        }
+        else
+        {
+            JPH::BodyInterface &interface = m_physicsSystem->GetBodyInterfaceNoLock();
+            JPH::BodyID bodyId = slot->bodyID;
+
+            if (!bodyId.IsInvalid() && interface.IsAdded(bodyId))
+            {
+                interface.RemoveBody(bodyId);
+                interface.DestroyBody(bodyId);
+            }
+        }
 
-        JPH::PhysicsSettings settings;
-        settings.mSpeculativeContactDistance = 0.0f;
+        slot->alive = false;
+        slot->bodyID = JPH::BodyID();
+        slot->layer = ObjectLayer::None;
+        slot->shape = nullptr;
+        slot->collision = {};
+        slot->settings = nullptr;
+        slot->data = 0;
 
-        m_physicsSystem->SetPhysicsSettings(settings);
+        ReleaseSlot(GetBodyIndex(id));
     }
 
-    void PhysicsWorld::Shutdown()
+    void PhysicsWorld::RemoveAllRigidBodies()
     {
-        // Unregisters all types with the factory and cleans up the default material
-        JPH::UnregisterTypes();
+        ClearCommands();
+        m_debris.clear();
+        m_autoMotionQuality.clear();
 
-        // Destroy the factory
-        delete JPH::Factory::sInstance;
-        JPH::Factory::sInstance = nullptr;
+        for (uint32_t i = 0; i < m_slots.size(); i++)
+        {
+            if (m_slots[i].alive)
+            {
+                RemoveRigidBody(MakeBodyID(i, m_slots[i].generation));
+            }
+        }
     }
 
-    void PhysicsWorld::StepSimulation(float dt, uint32_t numSubSteps)
+    void PhysicsWorld::SaveSnapshot(Snapshot &outSnapshot) const
     {
-        m_physicsSystem->Update(dt, numSubSteps, s_tempAllocator.get(), s_jobSystem.get());
+        const JPH::BodyInterface &interface = m_physicsSystem->GetBodyInterfaceNoLock();
 
-        const float collisionTolerance = 0.05f;
-        for (auto &[id, character] : m_characters)
+        outSnapshot.m_world = this;
+        outSnapshot.m_slots.resize(m_slots.size());
+        for (size_t i = 0; i < m_slots.size(); i++)
         {
-            character->PostSimulation(collisionTolerance);
+            BodyRecord &record = outSnapshot.m_slots[i];
+            record = m_slots[i];
+            if (record.alive && record.type == BodyType::Rigidbody)
+            {
+                record.gravityFactor = interface.GetGravityFactor(record.bodyID);
+            }
         }
-    }
-
-    RigidBodyState PhysicsWorld::GetRigidBodyState(BodyID id)
-    {
-        JPH::BodyInterface &interface = m_physicsSystem->GetBodyInterfaceNoLock();
-        JPH::BodyID bodyId = m_bodyIDs[id];
 
-        JPH::Vec3 position = interface.GetCenterOfMassPosition(bodyId);
-        JPH::Quat rotation = interface.GetRotation(bodyId);
-        JPH::Vec3 linearVelocity = interface.GetLinearVelocity(bodyId);
-        JPH::Vec3 angularVelocity = interface.GetAngularVelocity(bodyId);
+        SnapshotRecorder recorder(outSnapshot.m_state);
+        m_physicsSystem->SaveState(recorder);
 
-        return {
-            JoltHelpers::ConvertWithUnits(position),
-            JoltHelpers::Convert(rotation),
-            JoltHelpers::ConvertWithUnits(linearVelocity),
-            JoltHelpers::Convert(angularVelocity)};
-    }
+        // Characters keep their ground state outside of the body, restored in the same slot order
+        for (const BodySlot &slot : m_slots)
+        {
+            if (slot.alive && slot.character != nullptr)
+            {
+                slot.character->SaveState(recorder);
+            }
+            else if (const JPH::CharacterVirtual *character = slot.alive ? GetVirtualCharacter(slot) : nullptr)
+            {
+                character->SaveState(recorder);
+            }
+        }
 
-    glm::vec3 PhysicsWorld::GetPosition(BodyID id)
-    {
-        JPH::BodyInterface &interface = m_physicsSystem->GetBodyInterfaceNoLock();
-        JPH::BodyID bodyId = m_bodyIDs[id];
-        JPH::Vec3 position = interface.GetCenterOfMassPosition(bodyId);
-        return JoltHelpers::ConvertWithUnits(position);
+        m_contactListener.SaveState(outSnapshot.m_contactState);
+        outSnapshot.m_raycastProjectiles = m_raycastProjectiles;
     }
 
-    glm::vec3 PhysicsWorld::GetLinearVelocity(BodyID id)
+    bool PhysicsWorld::RestoreSnapshot(const Snapshot &snapshot)
     {
-        JPH::BodyInterface &interface = m_physicsSystem->GetBodyInterfaceNoLock();
-        JPH::BodyID bodyId = m_bodyIDs[id];
-        JPH::Vec3 linearVelocity = interface.GetLinearVelocity(bodyId);
-        return JoltHelpers::ConvertWithUnits(linearVelocity);
-    }
+        // Everything that can make the restore fail is checked here, before the world is changed
+        if (snapshot.m_world != this || snapshot.m_slots.size() > m_slots.size() || snapshot.m_state.empty())
+        {
+            std::cerr << "Failed to restore physics snapshot, it was not taken from this world" << std::endl;
+            return false;
+        }
 
-    ObjectLayer PhysicsWorld::GetObjectLayer(BodyID id) const
-    {
-        if (m_collisions.find(id) == m_collisions.end())
-            return ObjectLayer::None;
+        for (uint32_t i = 0; i < snapshot.m_slots.size(); i++)
+        {
+            const BodyRecord &saved = snapshot.m_slots[i];
+            const bool exists = m_slots[i].bodyID == saved.bodyID;
 
-        JPH::BodyInterface &interface = m_physicsSystem->GetBodyInterfaceNoLock();
-        JPH::BodyID bodyId = m_bodyIDs.at(id);
-        JPH::ObjectLayer layer = interface.GetObjectLayer(bodyId);
-        return static_cast<ObjectLayer>(layer);
-    }
+            // Characters create their own body, so one removed after the snapshot cannot get its old BodyID back
+            const bool isCharacter = saved.type == BodyType::Character || saved.type == BodyType::VirtualCharacter;
+            if (saved.alive && isCharacter && (!m_slots[i].alive || m_slots[i].type != saved.type || !exists))
+            {
+                std::cerr << "Failed to restore physics snapshot, character " << MakeBodyID(i, saved.generation) << " was removed after it was taken" << std::endl;
+                return false;
+            }
 
-    BodyID PhysicsWorld::CreateRigidBody(const RigidBodySettings &info, BodyType type)
-    {
-        assert(m_nextBodyID < std::numeric_limits<BodyID>::max() && "BodyID overflow");
+            if (!saved.bodyID.IsInvalid() && !exists && saved.settings == nullptr)
+            {
+                std::cerr << "Failed to restore physics snapshot, body " << MakeBodyID(i, saved.generation) << " cannot be recreated without its creation settings" << std::endl;
+                return false;
+            }
+        }
 
-        BodyID id = m_nextBodyID++;
+        ClearCommands();
         JPH::BodyInterface &interface = m_physicsSystem->GetBodyInterfaceNoLock();
 
-        static_assert(sizeof(UserData) == sizeof(JPH::uint64), "UserData must be 64 bits");
-        UserData userData{id, info.data};
-        uint64_t userDataBits = *reinterpret_cast<uint64_t *>(&userData); // :) I know
+        // Destroy bodies that did not exist when the snapshot was taken, pooled bodies created since are kept for the pool
+        for (uint32_t i = 0; i < m_slots.size(); i++)
+        {
+            BodySlot &slot = m_slots[i];
+            const bool inSnapshot = i < snapshot.m_slots.size();
+            if (slot.bodyID.IsInvalid() || (inSnapshot && snapshot.m_slots[i].bodyID == slot.bodyID))
+                continue;
 
-        // Creating shape
-        JPH::ShapeSettings::ShapeResult shapeResult = std::visit(
-            [&](const auto &shape)
-            { return shape.GetShapeSettings(); },
-            info.shape);
-        JPH::ShapeRefC shape = shapeResult.Get();
+            const bool keepPooled = !inSnapshot && slot.pool != c_invalidProjectilePoolID;
+            if (slot.alive && slot.type != BodyType::Rigidbody)
+            {
+                RemoveCharacter(slot);
+            }
+            else
+            {
+                if (interface.IsAdded(slot.bodyID))
+                {
+                    interface.RemoveBody(slot.bodyID);
+                }
+                if (!keepPooled)
+                {
+                    interface.DestroyBody(slot.bodyID);
+                }
+            }
 
-        m_collisions[id] = {info.shape, info.layer};
+            if (!keepPooled)
+            {
+                slot.bodyID = JPH::BodyID();
+            }
+        }
 
-        if (type == BodyType::Rigidbody)
+        // Bring back the slots of the snapshot, recreating bodies that were destroyed since under their old Jolt BodyID
+        for (uint32_t i = 0; i < snapshot.m_slots.size(); i++)
         {
-            JPH::ObjectLayer layer = info.layer != ObjectLayer::None ? static_cast<JPH::ObjectLayer>(info.layer) : info.mass > 0.0f ? Layers::MOVING
-                                                                                                                                    : Layers::NON_MOVING;
-            JPH::EMotionType motionType = info.mass > 0.0f ? JPH::EMotionType::Dynamic : JPH::EMotionType::Static;
+            const BodyRecord &saved = snapshot.m_slots[i];
+            BodySlot &slot = m_slots[i];
+            const bool exists = slot.bodyID == saved.bodyID;
+            static_cast<BodyRecord &>(slot) = saved;
 
-            JPH::BodyCreationSettings settings(shape, JoltHelpers::ConvertWithUnits(info.position), JoltHelpers::Convert(info.rotation), motionType, layer);
-            settings.mGravityFactor = info.gravityFactor;
-            settings.mMotionQuality = info.continuousCollision ? JPH::EMotionQuality::LinearCast : JPH::EMotionQuality::Discrete;
-            settings.mUserData = userDataBits;
-            settings.mIsSensor = info.isSensor;
-            JPH::BodyID bodyId = interface.CreateAndAddBody(settings, JPH::EActivation::Activate);
-            interface.SetLinearVelocity(bodyId, JoltHelpers::ConvertWithUnits(info.initialVelocity));
-            m_bodyIDs[id] = bodyId;
-        }
-        else if (type == BodyType::Character)
-        {
-            JPH::CharacterSettings settings;
-            settings.mShape = shape;
-            settings.mLayer = info.layer != ObjectLayer::None ? static_cast<JPH::ObjectLayer>(info.layer) : Layers::MOVING;
-            settings.mUp = JPH::Vec3::sAxisY();
-            settings.mGravityFactor = info.gravityFactor;
-            settings.mSupportingVolume = JPH::Plane(JPH::Vec3::sAxisY(), -shape->GetLocalBounds().GetExtent().GetY());
-            settings.mFriction = info.friction;
-            // Hardcoded for now
-            settings.mMaxSlopeAngle = glm::radians(45.0f);
+            if (saved.bodyID.IsInvalid())
+                continue;
 
-            std::unique_ptr<JPH::Character> character = std::make_unique<JPH::Character>(&settings, JoltHelpers::ConvertWithUnits(info.position), JoltHelpers::Convert(info.rotation), 0, m_physicsSystem.get());
-            character->AddToPhysicsSystem(JPH::EActivation::Activate);
-            JPH::BodyID bodyId = character->GetBodyID();
-            m_characters[id] = std::move(character);
-            m_bodyIDs[id] = bodyId;
-            interface.SetUserData(bodyId, userDataBits);
+            if (!exists)
+            {
+                if (interface.CreateBodyWithID(saved.bodyID, *saved.settings) == nullptr)
+                {
+                    std::cerr << "Failed to recreate body " << MakeBodyID(i, saved.generation) << " from physics snapshot" << std::endl;
+                    slot.alive = false;
+                    slot.bodyID = JPH::BodyID();
+                    continue;
+                }
+            }
+
+            if (saved.type == BodyType::Rigidbody)
+            {
+                const bool added = interface.IsAdded(saved.bodyID);
+                if (saved.alive && !added)
+                {
+                    interface.AddBody(saved.bodyID, JPH::EActivation::DontActivate);
+                }
+                else if (!saved.alive && added)
+                {
+                    interface.RemoveBody(saved.bodyID);
+                }
+
+                // Like the gravity factor, the layer is not part of the Jolt state
+                if (saved.alive)
+                {
+                    interface.SetGravityFactor(saved.bodyID, saved.gravityFactor);
+                    if (exists && interface.GetObjectLayer(saved.bodyID) != static_cast<JPH::ObjectLayer>(saved.layer))
+                    {
+                        interface.SetObjectLayer(saved.bodyID, static_cast<JPH::ObjectLayer>(saved.layer));
+                    }
+                }
+            }
+
+            // Pooled bodies get a new handle every time they are acquired
+            if (saved.alive)
+            {
+                interface.SetUserData(saved.bodyID, PackUserData(MakeBodyID(i, saved.generation), saved.data));
+            }
         }
-        else
+
+        // Slots created after the snapshot are freed, bumping the generation so their handles no longer resolve
+        for (uint32_t i = static_cast<uint32_t>(snapshot.m_slots.size()); i < m_slots.size(); i++)
         {
-            assert(false && "Unknown body type");
-        }
+            BodySlot &slot = m_slots[i];
+            if (slot.alive)
+            {
+                slot.alive = false;
+                slot.generation++;
+            }
 
-        return id;
-    }
+            if (slot.pool != c_invalidProjectilePoolID && !slot.bodyID.IsInvalid() && slot.generation < c_maxBodyGeneration)
+                continue;
 
-    void PhysicsWorld::RemoveRigidBody(BodyID id)
-    {
-        if (m_bodyIDs.find(id) == m_bodyIDs.end())
-            return;
+            if (!slot.bodyID.IsInvalid())
+            {
+                interface.DestroyBody(slot.bodyID);
+            }
+            static_cast<BodyRecord &>(slot) = {.generation = slot.generation, .pool = slot.pool};
+        }
 
-        if (m_characters.find(id) != m_characters.end())
+        // Free lists are rebuilt from the slots, which also picks up pooled bodies created since
+        m_freeSlots.clear();
+        for (ProjectilePool &pool : m_projectilePools)
         {
-            m_characters[id]->RemoveFromPhysicsSystem();
-            m_characters.erase(id);
+            pool.freeSlots.clear();
         }
-        else
+
+        for (uint32_t i = 0; i < m_slots.size(); i++)
         {
-            JPH::BodyInterface &interface = m_physicsSystem->GetBodyInterfaceNoLock();
-            JPH::BodyID &bodyId = m_bodyIDs[id];
+            const BodySlot &slot = m_slots[i];
+            if (slot.alive)
+                continue;
 
-            if (!bodyId.IsInvalid() && interface.IsAdded(bodyId))
+            if (slot.pool != c_invalidProjectilePoolID)
             {
-                interface.RemoveBody(bodyId);
-                interface.DestroyBody(bodyId);
+                if (!slot.bodyID.IsInvalid())
+                {
+                    m_projectilePools[slot.pool].freeSlots.push_back(i);
+                }
+            }
+            else if (slot.generation < c_maxBodyGeneration)
+            {
+                m_freeSlots.push_back(i);
             }
         }
 
-        m_bodyIDs.erase(id);
-        m_collisions.erase(id);
-    }
+        // Raycast projectiles only live in PhysicsWorld, their slots were restored with the others above
+        m_raycastProjectiles = snapshot.m_raycastProjectiles;
+        for (uint32_t i = 0; i < m_raycastProjectiles.ids.size(); i++)
+        {
+            m_slots[GetBodyIndex(m_raycastProjectiles.ids[i])].denseIndex = i;
+        }
 
-    void PhysicsWorld::RemoveAllRigidBodies()
-    {
-        std::vector<BodyID> idsToRemove;
-        for (auto &[id, bodyId] : m_bodyIDs)
+        // The bodies now match the ones the state was saved from, so Jolt only fails here on a corrupt snapshot
+        SnapshotRecorder recorder(std::span<const uint8_t>(snapshot.m_state));
+        if (!m_physicsSystem->RestoreState(recorder))
         {
-            idsToRemove.push_back(id);
+            assert(false && "Jolt rejected a validated physics snapshot");
+            std::cerr << "Failed to restore Jolt state from physics snapshot" << std::endl;
+            return false;
+        }
+
+        for (BodySlot &slot : m_slots)
+        {
+            if (slot.alive && slot.character != nullptr)
+            {
+                slot.character->RestoreState(recorder);
+            }
+            else if (JPH::CharacterVirtual *character = slot.alive ? GetVirtualCharacter(slot) : nullptr)
+            {
+                character->RestoreState(recorder);
+            }
         }
 
-        for (auto id : idsToRemove)
+        // Auto bodies are tracked again from the restored slots and re-evaluated before the next step
+        m_autoMotionQuality.clear();
+        for (uint32_t i = 0; i < m_slots.size(); i++)
         {
-            RemoveRigidBody(id);
+            const BodySlot &slot = m_slots[i];
+            if (slot.alive && slot.motionQuality == MotionQuality::Auto)
+            {
+                TrackMotionQuality(MakeBodyID(i, slot.generation), slot);
+            }
         }
 
-        m_nextBodyID = 0;
-        m_bodyIDs.clear();
+        m_contactListener.RestoreState(snapshot.m_contactState);
+
+        return !recorder.IsFailed();
     }
 
     void PhysicsWorld::SetPosition(BodyID id, glm::vec3 position)
     {
-        JPH::BodyInterface &interface = m_physicsSystem->GetBodyInterfaceNoLock();
-        JPH::BodyID bodyId = m_bodyIDs[id];
-        interface.SetPosition(bodyId, JoltHelpers::ConvertWithUnits(position), JPH::EActivation::Activate);
+        if (const BodySlot *slot = GetSlot(id))
+        {
+            if (JPH::CharacterVirtual *character = GetVirtualCharacter(*slot))
+            {
+                character->SetPosition(JoltHelpers::ConvertWithUnits(position));
+                return;
+            }
+
+            if (slot->type == BodyType::RaycastProjectile)
+            {
+                m_raycastProjectiles.positions[slot->denseIndex] = position;
+                return;
+            }
+
+            JPH::BodyInterface &interface = m_physicsSystem->GetBodyInterfaceNoLock();
+            interface.SetPosition(slot->bodyID, JoltHelpers::ConvertWithUnits(position), JPH::EActivation::Activate);
+        }
     }
 
     void PhysicsWorld::SetRotation(BodyID id, glm::quat rotation)
     {
-        JPH::BodyInterface &interface = m_physicsSystem->GetBodyInterfaceNoLock();
-        JPH::BodyID bodyId = m_bodyIDs[id];
-        interface.SetRotation(bodyId, JoltHelpers::Convert(rotation), JPH::EActivation::Activate);
+        if (const BodySlot *slot = GetSlot(id))
+        {
+            if (JPH::CharacterVirtual *character = GetVirtualCharacter(*slot))
+            {
+                character->SetRotation(JoltHelpers::Convert(rotation));
+                return;
+            }
+
+            if (slot->type == BodyType::RaycastProjectile)
+            {
+                m_raycastProjectiles.rotations[slot->denseIndex] = rotation;
+                return;
+            }
+
+            JPH::BodyInterface &interface = m_physicsSystem->GetBodyInterfaceNoLock();
+            interface.SetRotation(slot->bodyID, JoltHelpers::Convert(rotation), JPH::EActivation::Activate);
+        }
     }
 
     void PhysicsWorld::SetLinearVelocity(BodyID id, glm::vec3 velocity)
     {
-        JPH::BodyInterface &interface = m_physicsSystem->GetBodyInterfaceNoLock();
-        JPH::BodyID bodyId = m_bodyIDs[id];
-        interface.SetLinearVelocity(bodyId, JoltHelpers::ConvertWithUnits(velocity));
+        if (const BodySlot *slot = GetSlot(id))
+        {
+            if (JPH::CharacterVirtual *character = GetVirtualCharacter(*slot))
+            {
+                character->SetLinearVelocity(JoltHelpers::ConvertWithUnits(velocity));
+                return;
+            }
+
+            if (slot->type == BodyType::RaycastProjectile)
+            {
+                m_raycastProjectiles.velocities[slot->denseIndex] = velocity;
+                return;
+            }
+
+            JPH::BodyInterface &interface = m_physicsSystem->GetBodyInterfaceNoLock();
+            interface.SetLinearVelocity(slot->bodyID, JoltHelpers::ConvertWithUnits(velocity));
+        }
     }
 
     void PhysicsWorld::SetAngularVelocity(BodyID id, glm::vec3 velocity)
     {
-        JPH::BodyInterface &interface = m_physicsSystem->GetBodyInterfaceNoLock();
-        JPH::BodyID bodyId = m_bodyIDs[id];
-        interface.SetAngularVelocity(bodyId, JoltHelpers::Convert(velocity));
+        if (const BodySlot *slot = GetSlot(id))
+        {
+            assert(slot->type != BodyType::RaycastProjectile && "Raycast projectiles do not spin");
+            if (slot->type == BodyType::RaycastProjectile)
+                return;
+
+            JPH::BodyInterface &interface = m_physicsSystem->GetBodyInterfaceNoLock();
+            interface.SetAngularVelocity(slot->bodyID, JoltHelpers::Convert(velocity));
+        }
     }
 
     void PhysicsWorld::ApplyImpulse(BodyID id, const glm::vec3 &impulse)
     {
-        JPH::BodyInterface &interface = m_physicsSystem->GetBodyInterfaceNoLock();
-        JPH::BodyID bodyId = m_bodyIDs[id];
-        interface.AddForce(bodyId, JoltHelpers::ConvertWithUnits(impulse));
+        if (const BodySlot *slot = GetSlot(id))
+        {
+            assert(slot->type != BodyType::RaycastProjectile && "Raycast projectiles have no mass to apply an impulse to");
+            if (slot->type == BodyType::RaycastProjectile)
+                return;
+
+            JPH::BodyInterface &interface = m_physicsSystem->GetBodyInterfaceNoLock();
+            interface.AddImpulse(slot->bodyID, JoltHelpers::ConvertWithUnits(impulse));
+        }
     }
 
     void PhysicsWorld::SetGravityFactor(BodyID id, float factor)
     {
+        if (const BodySlot *slot = GetSlot(id))
+        {
+            if (slot->type == BodyType::VirtualCharacter)
+            {
+                m_virtualCharacters[slot->denseIndex].gravityFactor = factor;
+                return;
+            }
+
+            JPH::BodyInterface &interface = m_physicsSystem->GetBodyInterfaceNoLock();
+            interface.SetGravityFactor(slot->bodyID, factor);
+        }
+    }
+
+    void PhysicsWorld::SetDebris(BodyID id)
+    {
+        BodySlot *slot = GetSlot(id);
+        if (slot == nullptr || slot->type != BodyType::Rigidbody || slot->pool != c_invalidProjectilePoolID || slot->layer == ObjectLayer::Debris)
+            return;
+
         JPH::BodyInterface &interface = m_physicsSystem->GetBodyInterfaceNoLock();
-        JPH::BodyID bodyId = m_bodyIDs[id];
-        interface.SetGravityFactor(bodyId, factor);
+        interface.SetObjectLayer(slot->bodyID, Layers::DEBRIS);
+        interface.SetMotionQuality(slot->bodyID, JPH::EMotionQuality::Discrete);
+        slot->motionQuality = MotionQuality::Discrete;
+        slot->layer = ObjectLayer::Debris;
+        slot->collision.layer = ObjectLayer::Debris;
+
+        m_debris.push_back({id, 0.0f});
     }
 
     CharacterGroundState PhysicsWorld::GetCharacterGroundState(BodyID id)
     {
-        if (m_characters.find(id) == m_characters.end())
+        const BodySlot *slot = GetSlot(id);
+        if (slot == nullptr)
+            return CharacterGroundState::Unknown;
+
+        if (const JPH::CharacterVirtual *character = GetVirtualCharacter(*slot))
+            return static_cast<CharacterGroundState>(character->GetGroundState());
+
+        if (slot->character == nullptr)
             return CharacterGroundState::Unknown;
 
-        JPH::Character *character = m_characters[id].get();
-        JPH::Character::EGroundState state = character->GetGroundState();
+        JPH::Character::EGroundState state = slot->character->GetGroundState();
         return static_cast<CharacterGroundState>(state);
     }
 
     void PhysicsWorld::SetCharacterRotation(BodyID id, glm::quat rotation)
     {
-        if (m_characters.find(id) == m_characters.end())
+        const BodySlot *slot = GetSlot(id);
+        if (slot == nullptr)
             return;
 
-        JPH::Character *character = m_characters[id].get();
-        character->SetRotation(JoltHelpers::Convert(rotation));
+        if (JPH::CharacterVirtual *character = GetVirtualCharacter(*slot))
+        {
+            character->SetRotation(JoltHelpers::Convert(rotation));
+        }
+        else if (slot->character != nullptr)
+        {
+            slot->character->SetRotation(JoltHelpers::Convert(rotation));
+        }
     }
 
     void PhysicsWorld::RegisterContactListener(BodyID id)
@@ -310,11 +1642,16 @@ namespace mk
         m_contactListener.Unregister(id);
     }
 
-    const std::vector<Contact> &PhysicsWorld::GetContacts(BodyID id) const
+    std::span<const Contact> PhysicsWorld::GetContacts(BodyID id) const
     {
         return m_contactListener.GetContacts(id);
     }
 
+    std::span<const PairContact> PhysicsWorld::GetPairContacts() const
+    {
+        return m_contactListener.GetPairContacts();
+    }
+
     void PhysicsWorld::ResetContacts()
     {
         m_contactListener.ClearContacts();
@@ -398,4 +1735,92 @@ namespace mk
 
         return bodies;
     }
-}
\ No newline at end of file
+
+    uint32_t PhysicsWorld::OverlapShape(const JPH::Shape *shape, const JPH::RMat44 &transform, std::span<OverlapResult> outResults, ObjectLayerMask layers) const
+    {
+        const ObjectLayerMaskFilter layerFilter(layers);
+        OverlapCollector collector(outResults);
+
+        JPH::CollideShapeSettings settings;
+        m_physicsSystem->GetNarrowPhaseQuery().CollideShape(shape, JPH::Vec3::sReplicate(1.0f), transform, settings, JPH::RVec3::sZero(), collector, {}, layerFilter);
+        return collector.numFound;
+    }
+
+    uint32_t PhysicsWorld::OverlapSphere(const glm::vec3 &center, float radius, std::span<OverlapResult> outResults, ObjectLayerMask layers) const
+    {
+        JPH::SphereShape sphere(JoltHelpers::ToJolt(radius));
+        sphere.SetEmbedded();
+        return OverlapShape(&sphere, JPH::RMat44::sTranslation(JoltHelpers::ConvertWithUnits(center)), outResults, layers);
+    }
+
+    uint32_t PhysicsWorld::OverlapShape(const CollisionShape &shape, const glm::vec3 &position, const glm::quat &rotation, std::span<OverlapResult> outResults, ObjectLayerMask layers) const
+    {
+        JPH::ShapeRefC joltShape = std::visit([](const auto &shape)
+                                              { return shape.GetShapeSettings().Get(); },
+                                              shape);
+        // Jolt expects the center of mass transform of the query shape
+        const JPH::RMat44 transform = JPH::RMat44::sRotationTranslation(JoltHelpers::Convert(rotation), JoltHelpers::ConvertWithUnits(position)).PreTranslated(joltShape->GetCenterOfMass());
+        return OverlapShape(joltShape.GetPtr(), transform, outResults, layers);
+    }
+
+    void PhysicsWorld::RaycastBatch(std::span<const RaycastQuery> queries, std::span<RaycastResult> outResults, ObjectLayerMask layers) const
+    {
+        assert(outResults.size() >= queries.size() && "Output span too small");
+
+        const auto &query = m_physicsSystem->GetNarrowPhaseQuery();
+        const auto &interface = m_physicsSystem->GetBodyInterfaceNoLock();
+        const ObjectLayerMaskFilter layerFilter(layers);
+
+        ParallelFor(s_jobSystem.get(), queries.size(), c_queriesPerJob, [&](size_t begin, size_t end)
+                    {
+                        for (size_t i = begin; i < end; i++)
+                        {
+                            const RaycastQuery &raycast = queries[i];
+                            JPH::RRayCast ray;
+                            ray.mOrigin = JoltHelpers::ConvertWithUnits(raycast.from);
+                            ray.mDirection = JoltHelpers::ConvertWithUnits(raycast.direction * raycast.distance);
+
+                            JPH::RayCastResult hit;
+                            if (!query.CastRay(ray, hit, {}, layerFilter))
+                            {
+                                outResults[i] = {raycast.from + raycast.direction * raycast.distance, raycast.distance, c_invalidBodyID, 0};
+                                continue;
+                            }
+
+                            auto userDataBits = interface.GetUserData(hit.mBodyID);
+                            UserData userData = *reinterpret_cast<UserData *>(&userDataBits);
+                            outResults[i] = {
+                                JoltHelpers::ConvertWithUnits(ray.GetPointOnRay(hit.mFraction)),
+                                hit.mFraction * raycast.distance,
+                                userData.id,
+                                userData.data,
+                            };
+                        } });
+    }
+
+    void PhysicsWorld::CastSphereBatch(std::span<const SphereQuery> queries, std::span<BodyID> outBodies, std::span<uint32_t> outCounts, uint32_t maxHitsPerQuery, ObjectLayerMask layers) const
+    {
+        assert(outCounts.size() >= queries.size() && outBodies.size() >= queries.size() * maxHitsPerQuery && "Output span too small");
+
+        const auto &query = m_physicsSystem->GetBroadPhaseQuery();
+        const auto &interface = m_physicsSystem->GetBodyInterfaceNoLock();
+        const ObjectLayerMaskFilter layerFilter(layers);
+
+        ParallelFor(s_jobSystem.get(), queries.size(), c_queriesPerJob, [&](size_t begin, size_t end)
+                    {
+                        JPH::AllHitCollisionCollector<JPH::CollideShapeBodyCollector> collector;
+                        for (size_t i = begin; i < end; i++)
+                        {
+                            collector.Reset();
+                            query.CollideSphere(JoltHelpers::ConvertWithUnits(queries[i].center), JoltHelpers::ToJolt(queries[i].radius), collector, {}, layerFilter);
+
+                            const uint32_t count = std::min(static_cast<uint32_t>(collector.mHits.size()), maxHitsPerQuery);
+                            for (uint32_t j = 0; j < count; j++)
+                            {
+                                auto userDataBits = interface.GetUserData(collector.mHits[j]);
+                                outBodies[i * maxHitsPerQuery + j] = reinterpret_cast<UserData *>(&userDataBits)->id;
+                            }
+                            outCounts[i] = count;
+                        } });
+    }
+}
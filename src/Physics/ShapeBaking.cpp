@@ -0,0 +1,260 @@
+#include "Physics/ShapeBaking.h"
+#include "Physics/Helpers.h"
+
+#include "Jolt/Core/StreamIn.h"
+#include "Jolt/Core/StreamWrapper.h"
+#include "Jolt/Physics/Collision/PhysicsMaterial.h"
+#include "Jolt/Physics/Collision/Shape/ConvexHullShape.h"
+#include "Jolt/Physics/Collision/Shape/MeshShape.h"
+#include "Jolt/Physics/Collision/Shape/RotatedTranslatedShape.h"
+#include "Jolt/Physics/Collision/Shape/ScaledShape.h"
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace mk::ShapeBaking
+{
+    struct SidecarHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        BakedShapeType type;
+        uint32_t reserved;
+    };
+
+    // Read only view of a whole file, unmapped on destruction
+    class MappedFile
+    {
+    private:
+        const uint8_t *m_data = nullptr;
+        size_t m_size = 0;
+#ifdef _WIN32
+        HANDLE m_file = INVALID_HANDLE_VALUE;
+        HANDLE m_mapping = nullptr;
+#endif
+
+    public:
+        explicit MappedFile(const std::string &path)
+        {
+#ifdef _WIN32
+            m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (m_file == INVALID_HANDLE_VALUE)
+                return;
+
+            LARGE_INTEGER size;
+            if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0)
+                return;
+
+            m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (m_mapping == nullptr)
+                return;
+
+            m_data = static_cast<const uint8_t *>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+            m_size = m_data != nullptr ? static_cast<size_t>(size.QuadPart) : 0;
+#else
+            const int fd = open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+                return;
+
+            struct stat st;
+            if (fstat(fd, &st) == 0 && st.st_size > 0)
+            {
+                void *data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                if (data != MAP_FAILED)
+                {
+                    m_data = static_cast<const uint8_t *>(data);
+                    m_size = static_cast<size_t>(st.st_size);
+                }
+            }
+
+            // The mapping stays valid after the descriptor is closed
+            close(fd);
+#endif
+        }
+
+        ~MappedFile()
+        {
+#ifdef _WIN32
+            if (m_data != nullptr)
+                UnmapViewOfFile(m_data);
+            if (m_mapping != nullptr)
+                CloseHandle(m_mapping);
+            if (m_file != INVALID_HANDLE_VALUE)
+                CloseHandle(m_file);
+#else
+            if (m_data != nullptr)
+                munmap(const_cast<uint8_t *>(m_data), m_size);
+#endif
+        }
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        const uint8_t *GetData() const { return m_data; }
+        size_t GetSize() const { return m_size; }
+    };
+
+    // Jolt stream reading straight from the mapped memory, avoids copying the file into an std::istream
+    class MemoryStreamIn final : public JPH::StreamIn
+    {
+    private:
+        const uint8_t *m_data;
+        size_t m_size;
+        size_t m_offset = 0;
+        bool m_failed = false;
+
+    public:
+        MemoryStreamIn(const uint8_t *data, size_t size) : m_data(data), m_size(size) {}
+
+        void ReadBytes(void *outData, size_t inNumBytes) override
+        {
+            if (m_failed || m_offset + inNumBytes > m_size)
+            {
+                m_failed = true;
+                std::memset(outData, 0, inNumBytes);
+                return;
+            }
+
+            std::memcpy(outData, m_data + m_offset, inNumBytes);
+            m_offset += inNumBytes;
+        }
+
+        bool IsEOF() const override { return m_offset >= m_size; }
+        bool IsFailed() const override { return m_failed; }
+    };
+
+    bool BakeShape(BakedShapeType type, const std::vector<glm::vec3> &vertices, const std::vector<uint32_t> &indices, const std::string &path)
+    {
+        // Baked in model units, the unit scale is applied together with the model transform in TransformShape.
+        // Hull tolerances are absolute, so building at the 1/100 physics scale would lose detail on small models.
+        JPH::ShapeSettings::ShapeResult result;
+        switch (type)
+        {
+        case BakedShapeType::ConvexHull:
+        {
+            JPH::ConvexHullShapeSettings settings;
+            settings.mPoints.reserve(vertices.size());
+            for (const auto &vertex : vertices)
+            {
+                settings.mPoints.push_back(JoltHelpers::Convert(vertex));
+            }
+            result = settings.Create();
+        }
+        break;
+        case BakedShapeType::Mesh:
+        {
+            JPH::VertexList meshVertices;
+            meshVertices.reserve(vertices.size());
+            for (const auto &vertex : vertices)
+            {
+                meshVertices.push_back(JPH::Float3(vertex.x, vertex.y, vertex.z));
+            }
+
+            JPH::IndexedTriangleList triangles;
+            triangles.reserve(indices.size() / 3);
+            for (size_t i = 0; i + 2 < indices.size(); i += 3)
+            {
+                triangles.push_back(JPH::IndexedTriangle(indices[i], indices[i + 1], indices[i + 2]));
+            }
+
+            result = JPH::MeshShapeSettings(std::move(meshVertices), std::move(triangles)).Create();
+        }
+        break;
+        default:
+            assert(false && "Unknown baked shape type");
+            return false;
+        }
+
+        if (!result.IsValid())
+        {
+            std::cerr << "Failed to bake shape " << path << ": " << result.GetError() << std::endl;
+            return false;
+        }
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            std::cerr << "Failed to open shape sidecar for writing: " << path << std::endl;
+            return false;
+        }
+
+        const SidecarHeader header = {c_magic, c_version, type, 0};
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+        JPH::StreamOutWrapper stream(file);
+        JPH::Shape::ShapeToIDMap shapeMap;
+        JPH::Shape::MaterialToIDMap materialMap;
+        result.Get()->SaveWithChildren(stream, shapeMap, materialMap);
+
+        if (stream.IsFailed())
+        {
+            std::cerr << "Failed to write shape sidecar: " << path << std::endl;
+            return false;
+        }
+
+        std::cout << "Baked " << vertices.size() << " vertices into " << path << std::endl;
+        return true;
+    }
+
+    JPH::ShapeRefC LoadBakedShape(const std::string &path)
+    {
+        MappedFile file(path);
+        if (file.GetData() == nullptr)
+            return nullptr;
+
+        if (file.GetSize() < sizeof(SidecarHeader))
+        {
+            std::cerr << "Shape sidecar is truncated: " << path << std::endl;
+            return nullptr;
+        }
+
+        SidecarHeader header;
+        std::memcpy(&header, file.GetData(), sizeof(header));
+        if (header.magic != c_magic || header.version != c_version)
+        {
+            std::cerr << "Shape sidecar has an unknown format, rebake it: " << path << std::endl;
+            return nullptr;
+        }
+
+        MemoryStreamIn stream(file.GetData() + sizeof(header), file.GetSize() - sizeof(header));
+        JPH::Shape::IDToShapeMap shapeMap;
+        JPH::Shape::IDToMaterialMap materialMap;
+        JPH::ShapeSettings::ShapeResult result = JPH::Shape::sRestoreWithChildren(stream, shapeMap, materialMap);
+        if (!result.IsValid() || stream.IsFailed())
+        {
+            std::cerr << "Failed to restore shape sidecar " << path << ": " << (result.HasError() ? result.GetError().c_str() : "read past end") << std::endl;
+            return nullptr;
+        }
+
+        return result.Get();
+    }
+
+    JPH::ShapeRefC TransformShape(const JPH::ShapeRefC &shape, const glm::mat4 &transform)
+    {
+        const glm::vec3 translation = glm::vec3(transform[3]);
+        const glm::vec3 scale = glm::vec3(glm::length(glm::vec3(transform[0])), glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2])));
+        assert(glm::abs(scale.x - scale.y) < 1e-3f * scale.x && glm::abs(scale.x - scale.z) < 1e-3f * scale.x && "Baked shapes only support uniform scale");
+
+        const glm::quat rotation = glm::normalize(glm::quat_cast(glm::mat3(
+            glm::vec3(transform[0]) / scale.x,
+            glm::vec3(transform[1]) / scale.y,
+            glm::vec3(transform[2]) / scale.z)));
+
+        // Scale includes the model to physics unit conversion of the baked vertices
+        JPH::ShapeRefC scaled = JPH::ScaledShapeSettings(shape, JPH::Vec3::sReplicate(JoltHelpers::ToJolt(scale.x))).Create().Get();
+        return JPH::RotatedTranslatedShapeSettings(JoltHelpers::ConvertWithUnits(translation), JoltHelpers::Convert(rotation), scaled).Create().Get();
+    }
+}
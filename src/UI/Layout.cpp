@@ -52,7 +52,7 @@ namespace mk::Layout
             position);
     }
 
-    void Render(const SceneRenderer &renderer, UIContext &context, Container &container, const glm::vec2 &basePosition, const glm::vec2 &baseSize, const std::string &idString, const glm::vec2 &aspectRatio, const std::optional<Container> &parent, float scale, float zIndex, float opacity)
+    void Render(const Renderer &renderer, UIContext &context, Container &container, const glm::vec2 &basePosition, const glm::vec2 &baseSize, const std::string &idString, const glm::vec2 &aspectRatio, const std::optional<Container> &parent, float scale, float zIndex, float opacity)
     {
         const std::string currIdString = idString + container.id;
         UIState &state = context.uiStates[currIdString];
@@ -194,7 +194,7 @@ namespace mk::Layout
         }
     }
 
-    void Render(const SceneRenderer &renderer, UIContext &context, Text &text, const glm::vec2 &basePosition, const glm::vec2 &baseSize, const std::string &idString, const glm::vec2 &aspectRatio, const std::optional<Container> &parent, float scale, float zIndex, float opacity)
+    void Render(const Renderer &renderer, UIContext &context, Text &text, const glm::vec2 &basePosition, const glm::vec2 &baseSize, const std::string &idString, const glm::vec2 &aspectRatio, const std::optional<Container> &parent, float scale, float zIndex, float opacity)
     {
         const glm::vec2 position = GetPosition(text.position, basePosition, baseSize);
         const glm::vec2 size = GetSize(text.size, baseSize);
@@ -230,7 +230,7 @@ namespace mk::Layout
         }
     }
 
-    void Render(const SceneRenderer &renderer, UIContext &context, Image &image, const glm::vec2 &basePosition, const glm::vec2 &baseSize, const std::string &idString, const glm::vec2 &aspectRatio, const std::optional<Container> &parent, float scale, float zIndex, float opacity)
+    void Render(const Renderer &renderer, UIContext &context, Image &image, const glm::vec2 &basePosition, const glm::vec2 &baseSize, const std::string &idString, const glm::vec2 &aspectRatio, const std::optional<Container> &parent, float scale, float zIndex, float opacity)
     {
         const glm::vec2 position = GetPosition(image.position, basePosition, baseSize);
         const glm::vec2 size = GetSize(image.size, baseSize);
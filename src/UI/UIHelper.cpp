@@ -59,7 +59,7 @@ namespace mk::UIHelper
         return hash;
     }
 
-    glm::vec4 RenderLine(const SceneRenderer &renderer, UIContext &context, const std::string &text, const glm::vec2 &position, float size, const glm::vec4 &color, TextAlignment alignment, bool centerVertically)
+    glm::vec4 RenderLine(const Renderer &renderer, UIContext &context, const std::string &text, const glm::vec2 &position, float size, const glm::vec4 &color, TextAlignment alignment, bool centerVertically)
     {
         std::vector<FontGlyph> glyphs = renderer.GetTextGlyphs(context.fontAtlas, text);
 
@@ -164,7 +164,7 @@ namespace mk::UIHelper
         return lines;
     }
 
-    glm::vec4 RenderText(const SceneRenderer &renderer, UIContext &context, const std::string &text, const glm::vec2 &position, float size, const glm::vec4 &color, TextAlignment alignment, bool centerVertically, uint32_t maxLineLength, float lineSpacing)
+    glm::vec4 RenderText(const Renderer &renderer, UIContext &context, const std::string &text, const glm::vec2 &position, float size, const glm::vec4 &color, TextAlignment alignment, bool centerVertically, uint32_t maxLineLength, float lineSpacing)
     {
         std::vector<std::string> lines;
 
@@ -192,7 +192,7 @@ namespace mk::UIHelper
         return glm::vec4(min, max);
     }
 
-    glm::vec4 RenderText(SceneRenderer &renderer, RenderHandle fontAtlas, RenderHandle fontMaterial, const std::string &text, const glm::vec2 &position, float size, const glm::vec4 &color, TextAlignment alignment, bool centerVertically, uint32_t maxLineLength, float lineSpacing)
+    glm::vec4 RenderText(Renderer &renderer, RenderHandle fontAtlas, RenderHandle fontMaterial, const std::string &text, const glm::vec2 &position, float size, const glm::vec4 &color, TextAlignment alignment, bool centerVertically, uint32_t maxLineLength, float lineSpacing)
     {
         UIContext context{
             .fontAtlas = fontAtlas,
@@ -214,7 +214,7 @@ namespace mk::UIHelper
         return bounds;
     }
 
-    void RenderProgressBar(SceneRenderer &renderer, RenderHandle material, const glm::vec2 &position, const glm::vec2 &size, const glm::vec2 &texCoord, const glm::vec2 &texSize, float percent, const glm::vec4 &fillColor, const glm::vec4 &backgroundColor, float aspectRatio)
+    void RenderProgressBar(Renderer &renderer, RenderHandle material, const glm::vec2 &position, const glm::vec2 &size, const glm::vec2 &texCoord, const glm::vec2 &texSize, float percent, const glm::vec4 &fillColor, const glm::vec4 &backgroundColor, float aspectRatio)
     {
         const float x = position.x;
         const float y = position.y;
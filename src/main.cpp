@@ -32,10 +32,14 @@ int MainImpl(int argc, char **argv)
     return app.Run(argc, argv);
 }
 
-// int main(int argc, char **argv)
-// {
-//     return MainImpl(argc, argv);
-// }
+#if defined(MK_HEADLESS) || !defined(_WIN32)
+
+int main(int argc, char **argv)
+{
+    return MainImpl(argc, argv);
+}
+
+#else
 
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR lpCmdLine, int nCmdShow)
 {
@@ -43,4 +47,6 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR lpCmdLine,
     RedirectOutputToFile();
 #endif
     return MainImpl(__argc, __argv);
-}
\ No newline at end of file
+}
+
+#endif
\ No newline at end of file
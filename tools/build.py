@@ -14,7 +14,7 @@ ENGINE_ASSET_DIR = "./third_party/vultron/Vultron/assets/"
 SHADER_EXT = ".spv"
 ENGINE_FILES = ["brdf.dat", "skybox.dat"]
 ASSET_DIR = "./assets"
-ASSET_EXT = [".dat", ".bank"]
+ASSET_EXT = [".dat", ".bank", ".shape"]
 GAME_NAME = "monke"
 VERSION_FILE = "./VERSION"
 